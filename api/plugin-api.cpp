@@ -1,4 +1,5 @@
 #include "plugin-api.hpp"
+#include "compat/timer.hpp"
 
 using namespace plugin_api::detail;
 
@@ -26,6 +27,39 @@ void BaseDialog::closeEvent(QCloseEvent*)
 
 bool ITracker::center() { return false; }
 
+void ITracker::notify_new_sample()
+{
+    notify_new_sample(Timer::now_nsecs());
+}
+
+void ITracker::notify_new_sample(long long capture_nsecs)
+{
+    sample_nsecs.store(capture_nsecs, std::memory_order_relaxed);
+
+    {
+        std::unique_lock<std::mutex> l(sample_mtx);
+        sample_ready = true;
+    }
+    sample_cvar.notify_one();
+}
+
+bool ITracker::wait_for_new_sample(int timeout_ms)
+{
+    std::unique_lock<std::mutex> l(sample_mtx);
+
+    if (timeout_ms > 0)
+        sample_cvar.wait_for(l, std::chrono::milliseconds(timeout_ms), [this] { return sample_ready; });
+
+    const bool ret = sample_ready;
+    sample_ready = false;
+    return ret;
+}
+
+long long ITracker::sample_time() const
+{
+    return sample_nsecs.load(std::memory_order_relaxed);
+}
+
 module_status ITracker::status_ok()
 {
     return module_status();
@@ -18,6 +18,10 @@
 #include "compat/simple-mat.hpp"
 #include "export.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
 using Pose = Mat<double, 6, 1>;
 
 enum Axis {
@@ -180,12 +184,31 @@ struct OTR_API_EXPORT ITracker
     // returning true makes identity the center pose
     virtual bool center();
 
+    // optionally call from your own thread once data() has a new pose to return.
+    // the pipeline wakes up right away instead of at its next poll interval.
+    // trackers that never call it keep working with the timed poll.
+    // pass Timer::now_nsecs() from when the sample was captured to get
+    // its latency measured, otherwise the notification time is used.
+    void notify_new_sample();
+    void notify_new_sample(long long capture_nsecs);
+    // used by the pipeline. wait up to `timeout_ms' for notify_new_sample().
+    // returns true if a new sample arrived, consuming the notification.
+    bool wait_for_new_sample(int timeout_ms);
+    // capture time of the latest notified sample, 0 if the tracker never notifies
+    long long sample_time() const;
+
     static module_status status_ok();
     static module_status error(const QString& error);
 
     ITracker(const ITracker&) = delete;
     ITracker(ITracker&&) = delete;
     ITracker& operator=(const ITracker&) = delete;
+
+private:
+    std::mutex sample_mtx;
+    std::condition_variable sample_cvar;
+    std::atomic<long long> sample_nsecs { 0 };
+    bool sample_ready = false;
 };
 
 struct OTR_API_EXPORT ITrackerDialog : public plugin_api::detail::BaseDialog
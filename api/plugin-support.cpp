@@ -0,0 +1,522 @@
+#include "plugin-support.hpp"
+#include "options/group.hpp"
+
+#include <map>
+#include <set>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QImage>
+#include <QPixmap>
+#include <QCoreApplication>
+#include <QGuiApplication>
+
+// what enum_libraries() needs from each module, so that only
+// the ones actually used have to be loaded.
+namespace {
+
+struct module_cache final
+{
+    struct entry
+    {
+        qint64 mtime = 0, size = 0;
+        quint32 type = dylib::Invalid;
+        QString name;
+        QList<QImage> icon;
+        // some modules have no icon, so an empty one can be final
+        bool icon_known = false;
+    };
+
+    // by full pathname
+    std::map<QString, entry> entries;
+
+    static constexpr quint32 magic = 0x6f74726d; // "otrm"
+    static constexpr quint32 version = 2;
+
+    static QString pathname();
+    void load();
+    void save() const;
+
+    static QList<QImage> icon_to_images(const QIcon& icon);
+    static QIcon images_to_icon(const QList<QImage>& images);
+};
+
+constexpr quint32 module_cache::magic;
+constexpr quint32 module_cache::version;
+
+QString module_cache::pathname()
+{
+    const QString dir = options::group::ini_directory();
+    if (dir.isEmpty())
+        return QString();
+    return dir + QStringLiteral("/modules.cache");
+}
+
+void module_cache::load()
+{
+    const QString path = pathname();
+
+    if (path.isEmpty())
+        return;
+
+    QFile f(path);
+
+    if (!f.open(QFile::ReadOnly))
+        return;
+
+    QDataStream ds(&f);
+    ds.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic_ = 0, version_ = 0, count = 0;
+    ds >> magic_ >> version_ >> count;
+
+    if (ds.status() != QDataStream::Ok || magic_ != magic || version_ != version)
+        return;
+
+    for (quint32 i = 0; i < count && ds.status() == QDataStream::Ok; i++)
+    {
+        QString filename;
+        entry e;
+        ds >> filename >> e.mtime >> e.size >> e.type >> e.name >> e.icon >> e.icon_known;
+        entries[filename] = std::move(e);
+    }
+
+    if (ds.status() != QDataStream::Ok)
+    {
+        qDebug() << "module cache: can't read" << path;
+        entries.clear();
+    }
+}
+
+void module_cache::save() const
+{
+    const QString path = pathname();
+
+    if (path.isEmpty())
+        return;
+
+    QSaveFile f(path);
+
+    if (!f.open(QFile::WriteOnly))
+        return;
+
+    QDataStream ds(&f);
+    ds.setVersion(QDataStream::Qt_5_0);
+
+    ds << magic << version << quint32(entries.size());
+
+    for (const auto& x : entries)
+    {
+        const entry& e = x.second;
+        ds << x.first << e.mtime << e.size << e.type << e.name << e.icon << e.icon_known;
+    }
+
+    if (ds.status() != QDataStream::Ok)
+    {
+        qDebug() << "module cache: can't write" << path;
+        f.cancelWriting();
+    }
+
+    (void) f.commit();
+}
+
+// the icon usually points into the module's own resources,
+// which are gone until it's loaded again
+QList<QImage> module_cache::icon_to_images(const QIcon& icon)
+{
+    QList<QImage> ret;
+
+    QList<QSize> sizes = icon.availableSizes();
+    if (sizes.isEmpty())
+        sizes.push_back(QSize(16, 16));
+
+    for (const QSize& sz : sizes)
+    {
+        const QImage img = icon.pixmap(sz).toImage();
+        if (!img.isNull())
+            ret.push_back(img);
+    }
+
+    return ret;
+}
+
+QIcon module_cache::images_to_icon(const QList<QImage>& images)
+{
+    QIcon ret;
+    for (const QImage& img : images)
+        ret.addPixmap(QPixmap::fromImage(img));
+    return ret;
+}
+
+struct module_slot
+{
+    QString filename;
+    dylib::Type type = dylib::Invalid;
+    qint64 mtime = 0, size = 0;
+    std::shared_ptr<dylib> lib;
+    bool cached = false;
+    // milliseconds spent loading it
+    double time = 0;
+};
+
+// modules that weren't in the cache, a few at a time. only the name is
+// read here, the icon waits for load_icons().
+void load_uncached(const std::vector<module_slot*>& xs)
+{
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+
+    std::atomic<unsigned> next { 0 };
+
+    const auto fun = [&] {
+        for (unsigned i; (i = next++) < xs.size(); )
+        {
+            module_slot& x = *xs[i];
+            const clock::time_point t = clock::now();
+
+            if (x.lib->load())
+                x.lib->name = std::unique_ptr<Metadata>(x.lib->Meta())->name();
+
+            x.time = ms(clock::now() - t).count();
+        }
+    };
+
+    static constexpr unsigned max_threads = 4;
+    const unsigned nthreads = std::min({ max_threads,
+                                         std::max(1u, std::thread::hardware_concurrency()),
+                                         unsigned(xs.size()) });
+
+    std::vector<std::thread> threads;
+
+    for (unsigned i = 1; i < nthreads; i++)
+        threads.emplace_back(fun);
+
+    fun();
+
+    for (std::thread& t : threads)
+        t.join();
+}
+
+} // ns
+
+dylib::dylib(const QString& filename_, Type t) :
+    type(Invalid),
+    full_filename(filename_),
+    module_name(trim_filename(filename_)),
+    Dialog(nullptr),
+    Constructor(nullptr),
+    Meta(nullptr)
+{
+    // otherwise dlopen opens the calling executable
+    if (filename_.size() == 0 || module_name.size() == 0)
+        return;
+
+    if (!resolve())
+        return;
+
+    auto m = std::unique_ptr<Metadata>(Meta());
+
+    icon = m->icon();
+    name = m->name();
+
+    type = t;
+}
+
+dylib::dylib(const QString& filename_, Type t, const QString& name_, const QIcon& icon_) :
+    type(t),
+    full_filename(filename_),
+    module_name(trim_filename(filename_)),
+    icon(icon_),
+    name(name_),
+    Dialog(nullptr),
+    Constructor(nullptr),
+    Meta(nullptr)
+{
+    if (filename_.size() == 0 || module_name.size() == 0)
+        type = Invalid;
+}
+
+dylib::~dylib()
+{
+    // QLibrary refcounts the .dll's so don't forcefully unload
+}
+
+bool dylib::load()
+{
+    std::lock_guard<std::mutex> l(mtx);
+
+    if (Constructor)
+        return true;
+
+    if (type == Invalid)
+        return false;
+
+    return resolve();
+}
+
+bool dylib::resolve()
+{
+    handle.setFileName(full_filename);
+    handle.setLoadHints(QLibrary::DeepBindHint | QLibrary::ResolveAllSymbolsHint);
+
+    if (check(!handle.load()))
+        return false;
+
+    if (check((Dialog = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetDialog"), !Dialog)))
+        return false;
+
+    if (check((Constructor = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetConstructor"), !Constructor)))
+        return false;
+
+    if (check((Meta = (OPENTRACK_METADATA_FUNPTR) handle.resolve("GetMetadata"), !Meta)))
+        return false;
+
+    return true;
+}
+
+QList<std::shared_ptr<dylib>> dylib::enum_libraries(const QString& library_path)
+{
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+
+    const clock::time_point start = clock::now();
+
+    QDir module_directory(library_path);
+    QList<std::shared_ptr<dylib>> ret;
+
+    static const struct filter_ {
+        Type type;
+        QString glob;
+    } filters[] = {
+        { Filter, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-filter-*." OPENTRACK_SOLIB_EXT), },
+        { Tracker, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-tracker-*." OPENTRACK_SOLIB_EXT), },
+        { Protocol, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-proto-*." OPENTRACK_SOLIB_EXT), },
+        { Extension, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-ext-*." OPENTRACK_SOLIB_EXT), },
+    };
+
+    // icons need a QGuiApplication
+    const bool gui = qobject_cast<QGuiApplication*>(QCoreApplication::instance()) != nullptr;
+
+    module_cache cache;
+    cache.load();
+
+    std::vector<module_slot> found;
+
+    for (const filter_& filter : filters)
+    {
+        for (const QString& filename : module_directory.entryList({ filter.glob }, QDir::Files, QDir::Name))
+        {
+            module_slot x;
+
+            x.filename = filename;
+            x.type = filter.type;
+
+            const QString pathname = QStringLiteral("%1/%2").arg(library_path).arg(filename);
+            const QFileInfo info(pathname);
+            x.mtime = info.lastModified().toMSecsSinceEpoch();
+            x.size = info.size();
+
+            auto it = cache.entries.find(pathname);
+
+            if (it != cache.entries.end() &&
+                it->second.mtime == x.mtime && it->second.size == x.size && it->second.type == x.type)
+            {
+                const module_cache::entry& e = it->second;
+                x.lib = std::make_shared<dylib>(pathname, x.type, e.name,
+                                                gui ? module_cache::images_to_icon(e.icon) : QIcon());
+                // cached by something without a gui
+                x.lib->icon_pending = !e.icon_known;
+                x.cached = true;
+            }
+            else
+                x.lib = std::make_shared<dylib>(pathname, x.type, QString(), QIcon());
+
+            found.push_back(std::move(x));
+        }
+    }
+
+    {
+        std::vector<module_slot*> misses;
+        for (module_slot& x : found)
+            if (!x.cached)
+                misses.push_back(&x);
+        load_uncached(misses);
+    }
+
+    std::set<QString> seen;
+    bool modified = false;
+
+    // in the same order as the files were listed, so that
+    // the first of two modules with the same name wins
+    for (module_slot& x : found)
+    {
+        std::shared_ptr<dylib>& lib = x.lib;
+
+        seen.insert(lib->full_filename);
+
+        if (!x.cached)
+        {
+            qDebug() << "module" << x.filename << "took" << x.time << "ms";
+
+            auto it = cache.entries.find(lib->full_filename);
+
+            if (it != cache.entries.end())
+            {
+                cache.entries.erase(it);
+                modified = true;
+            }
+
+            // failures aren't kept, a missing dependency could get installed later
+            if (lib->type != Invalid)
+            {
+                lib->icon_pending = true;
+
+                module_cache::entry e;
+                e.mtime = x.mtime;
+                e.size = x.size;
+                e.type = x.type;
+                e.name = lib->name;
+                cache.entries[lib->full_filename] = std::move(e);
+                modified = true;
+            }
+        }
+
+        if (lib->type == Invalid)
+            continue;
+
+        if (std::any_of(ret.cbegin(),
+                        ret.cend(),
+                        [&lib](const std::shared_ptr<dylib>& a) {
+                            return a->type == lib->type && a->name == lib->name;
+                        }))
+        {
+            qDebug() << "duplicate lib" << x.filename << "ident" << lib->name;
+            continue;
+        }
+
+        ret.push_back(lib);
+    }
+
+    // modules that were removed. other installs' entries stay.
+    const QString prefix = library_path + QStringLiteral("/");
+    for (auto it = cache.entries.begin(); it != cache.entries.end(); )
+    {
+        if (it->first.startsWith(prefix) && seen.find(it->first) == seen.end())
+        {
+            it = cache.entries.erase(it);
+            modified = true;
+        }
+        else
+            it++;
+    }
+
+    if (modified)
+        cache.save();
+
+    qDebug() << "enumerated" << found.size() << "modules in" << ms(clock::now() - start).count() << "ms";
+
+    return ret;
+}
+
+bool dylib::load_icons(const QList<std::shared_ptr<dylib>>& libs)
+{
+    if (!qobject_cast<QGuiApplication*>(QCoreApplication::instance()))
+        return false;
+
+    module_cache cache;
+    bool any = false;
+
+    for (const std::shared_ptr<dylib>& lib : libs)
+    {
+        if (!lib->icon_pending)
+            continue;
+
+        lib->icon_pending = false;
+
+        // loaded already unless it came from the cache
+        if (!lib->load())
+            continue;
+
+        lib->icon = std::unique_ptr<Metadata>(lib->Meta())->icon();
+
+        if (!any)
+            cache.load();
+        any = true;
+
+        auto it = cache.entries.find(lib->full_filename);
+        if (it != cache.entries.end())
+        {
+            it->second.icon = module_cache::icon_to_images(lib->icon);
+            it->second.icon_known = true;
+        }
+    }
+
+    if (any)
+        cache.save();
+
+    return any;
+}
+
+QString dylib::trim_filename(const QString& in_)
+{
+    QStringRef in(&in_);
+
+    const int idx = in.lastIndexOf("/");
+
+    if (idx != -1)
+    {
+        in = in.mid(idx + 1);
+
+        if (in.startsWith(OPENTRACK_SOLIB_PREFIX) &&
+            in.endsWith("." OPENTRACK_SOLIB_EXT))
+        {
+            constexpr unsigned pfx_len = sizeof(OPENTRACK_SOLIB_PREFIX) - 1;
+            constexpr unsigned rst_len = sizeof("." OPENTRACK_SOLIB_EXT) - 1;
+
+            in = in.mid(pfx_len);
+            in = in.left(in.size() - rst_len);
+
+            static const char* names[] =
+            {
+                "opentrack-tracker-",
+                "opentrack-proto-",
+                "opentrack-filter-",
+                "opentrack-ext-",
+            };
+
+            for (auto name : names)
+            {
+                if (in.startsWith(name))
+                    return in.mid(std::strlen(name)).toString();
+            }
+        }
+    }
+    return QString();
+}
+
+bool dylib::check(bool fail)
+{
+    if (fail)
+    {
+        qDebug() << "library" << module_name << "failed:" << handle.errorString();
+
+        if (handle.isLoaded())
+            (void) handle.unload();
+
+        Constructor = nullptr;
+        Dialog = nullptr;
+        Meta = nullptr;
+
+        type = Invalid;
+    }
+
+    return fail;
+}
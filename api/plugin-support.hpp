@@ -8,10 +8,11 @@
 #pragma once
 
 #include "plugin-api.hpp"
+#include "export.hpp"
 
 #include <memory>
+#include <mutex>
 #include <algorithm>
-#include <cstring>
 
 #include <QDebug>
 #include <QString>
@@ -38,7 +39,7 @@
 extern "C" typedef void* (*OPENTRACK_CTOR_FUNPTR)(void);
 extern "C" typedef Metadata* (*OPENTRACK_METADATA_FUNPTR)(void);
 
-struct dylib final
+struct OTR_API_EXPORT dylib final
 {
     enum Type : unsigned
     {
@@ -49,85 +50,21 @@ struct dylib final
         Invalid = 0xcafebabeu,
     };
 
-    dylib(const QString& filename_, Type t) :
-        type(Invalid),
-        full_filename(filename_),
-        module_name(trim_filename(filename_)),
-        Dialog(nullptr),
-        Constructor(nullptr),
-        Meta(nullptr)
-    {
-        // otherwise dlopen opens the calling executable
-        if (filename_.size() == 0 || module_name.size() == 0)
-            return;
-
-        handle.setFileName(filename_);
-        handle.setLoadHints(QLibrary::DeepBindHint | QLibrary::ResolveAllSymbolsHint);
-
-        if (check(!handle.load()))
-            return;
-
-        if (check((Dialog = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetDialog"), !Dialog)))
-            return;
-
-        if (check((Constructor = (OPENTRACK_CTOR_FUNPTR) handle.resolve("GetConstructor"), !Constructor)))
-            return;
-
-        if (check((Meta = (OPENTRACK_METADATA_FUNPTR) handle.resolve("GetMetadata"), !Meta)))
-            return;
-
-        auto m = std::unique_ptr<Metadata>(Meta());
-
-        icon = m->icon();
-        name = m->name();
-
-        type = t;
-    }
-    ~dylib()
-    {
-        // QLibrary refcounts the .dll's so don't forcefully unload
-    }
+    // loads the module right away
+    dylib(const QString& filename_, Type t);
+    // from the module cache, doesn't load anything until load()
+    dylib(const QString& filename_, Type t, const QString& name_, const QIcon& icon_);
+    ~dylib();
 
-    static QList<std::shared_ptr<dylib>> enum_libraries(const QString& library_path)
-    {
-        QDir module_directory(library_path);
-        QList<std::shared_ptr<dylib>> ret;
+    // modules new since the last start are listed without an icon
+    static QList<std::shared_ptr<dylib>> enum_libraries(const QString& library_path);
+    // sets the icons enum_libraries() left out, and caches them.
+    // gui thread, after the main window's up. false if there were none.
+    static bool load_icons(const QList<std::shared_ptr<dylib>>& libs);
 
-        static const struct filter_ {
-            Type type;
-            QString glob;
-        } filters[] = {
-            { Filter, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-filter-*." OPENTRACK_SOLIB_EXT), },
-            { Tracker, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-tracker-*." OPENTRACK_SOLIB_EXT), },
-            { Protocol, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-proto-*." OPENTRACK_SOLIB_EXT), },
-            { Extension, QStringLiteral(OPENTRACK_SOLIB_PREFIX "opentrack-ext-*." OPENTRACK_SOLIB_EXT), },
-        };
-
-        for (const filter_& filter : filters)
-        {
-            for (const QString& filename : module_directory.entryList({ filter.glob }, QDir::Files, QDir::Name))
-            {
-                std::shared_ptr<dylib> lib = std::make_shared<dylib>(QStringLiteral("%1/%2").arg(library_path).arg(filename), filter.type);
-
-                if (lib->type == Invalid)
-                    continue;
-
-                if (std::any_of(ret.cbegin(),
-                                ret.cend(),
-                                [&lib](const std::shared_ptr<dylib>& a) {
-                                    return a->type == lib->type && a->name == lib->name;
-                                }))
-                {
-                    qDebug() << "duplicate lib" << filename << "ident" << lib->name;
-                    continue;
-                }
-
-                ret.push_back(lib);
-            }
-        }
-
-        return ret;
-    }
+    // resolves the functions below, if they weren't already.
+    // false if the module can't be used.
+    bool load();
 
     Type type;
     QString full_filename;
@@ -141,62 +78,12 @@ struct dylib final
     OPENTRACK_METADATA_FUNPTR Meta;
 private:
     QLibrary handle;
+    std::mutex mtx;
+    bool icon_pending = false;
 
-    static QString trim_filename(const QString& in_)
-    {
-        QStringRef in(&in_);
-
-        const int idx = in.lastIndexOf("/");
-
-        if (idx != -1)
-        {
-            in = in.mid(idx + 1);
-
-            if (in.startsWith(OPENTRACK_SOLIB_PREFIX) &&
-                in.endsWith("." OPENTRACK_SOLIB_EXT))
-            {
-                constexpr unsigned pfx_len = sizeof(OPENTRACK_SOLIB_PREFIX) - 1;
-                constexpr unsigned rst_len = sizeof("." OPENTRACK_SOLIB_EXT) - 1;
-
-                in = in.mid(pfx_len);
-                in = in.left(in.size() - rst_len);
-
-                static const char* names[] =
-                {
-                    "opentrack-tracker-",
-                    "opentrack-proto-",
-                    "opentrack-filter-",
-                    "opentrack-ext-",
-                };
-
-                for (auto name : names)
-                {
-                    if (in.startsWith(name))
-                        return in.mid(std::strlen(name)).toString();
-                }
-            }
-        }
-        return QString();
-    }
-
-    bool check(bool fail)
-    {
-        if (fail)
-        {
-            qDebug() << "library" << module_name << "failed:" << handle.errorString();
-
-            if (handle.isLoaded())
-                (void) handle.unload();
-
-            Constructor = nullptr;
-            Dialog = nullptr;
-            Meta = nullptr;
-
-            type = Invalid;
-        }
-
-        return fail;
-    }
+    bool resolve();
+    static QString trim_filename(const QString& in_);
+    bool check(bool fail);
 };
 
 struct Modules final
@@ -215,6 +102,7 @@ struct Modules final
     dylib_list& trackers() { return tracker_modules; }
     dylib_list& protocols() { return protocol_modules; }
     dylib_list& extensions() { return extension_modules; }
+    bool load_icons() { return dylib::load_icons(module_list); }
 private:
     dylib_list module_list;
     dylib_list filter_modules;
@@ -243,7 +131,7 @@ template<typename t>
 static inline std::shared_ptr<t> make_dylib_instance(const std::shared_ptr<dylib>& lib)
 {
     std::shared_ptr<t> ret;
-    if (lib != nullptr && lib->Constructor)
+    if (lib != nullptr && lib->load())
         ret = std::shared_ptr<t>(reinterpret_cast<t*>(reinterpret_cast<OPENTRACK_CTOR_FUNPTR>(lib->Constructor)()));
     return ret;
 }
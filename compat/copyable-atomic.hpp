@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+
+// for members of classes that need to stay copyable.
+// copying isn't atomic with respect to both operands at once.
+
+template<typename t>
+class copyable_atomic final : public std::atomic<t>
+{
+    using base = std::atomic<t>;
+
+public:
+    copyable_atomic(t value = t()) : base(value) {}
+    copyable_atomic(const copyable_atomic& other) : base(other.load()) {}
+
+    copyable_atomic& operator=(const copyable_atomic& other)
+    {
+        base::store(other.load());
+        return *this;
+    }
+
+    t operator=(t value)
+    {
+        base::store(value);
+        return value;
+    }
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "value-templates.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+
+// single writer, multiple readers. readers never block the writer, they
+// retry when they race with a store instead. only for trivially copyable types.
+// the payload is kept in relaxed atomic words so that torn reads are
+// well-defined and merely get discarded.
+
+template<typename t>
+class seqlock final
+{
+    static_assert(is_trivially_copyable_v<t>, "seqlock needs a trivially copyable type");
+
+    using word = std::uintptr_t;
+    static constexpr unsigned nwords = (sizeof(t) + sizeof(word) - 1) / sizeof(word);
+
+    std::atomic<unsigned> seq { 0 };
+    std::atomic<word> data[nwords];
+
+public:
+    seqlock()
+    {
+        for (std::atomic<word>& w : data)
+            w.store(0, std::memory_order_relaxed);
+    }
+
+    explicit seqlock(const t& value) : seqlock()
+    {
+        store(value);
+    }
+
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    // must only ever be called from a single thread
+    void store(const t& value)
+    {
+        word buf[nwords] {};
+        std::memcpy(buf, &value, sizeof(t));
+
+        const unsigned s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (unsigned i = 0; i < nwords; i++)
+            data[i].store(buf[i], std::memory_order_relaxed);
+
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    t load() const
+    {
+        word buf[nwords];
+
+        for (;;)
+        {
+            const unsigned s = seq.load(std::memory_order_acquire);
+
+            if (s & 1u)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (unsigned i = 0; i < nwords; i++)
+                buf[i] = data[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (seq.load(std::memory_order_relaxed) == s)
+                break;
+        }
+
+        t ret;
+        std::memcpy(&ret, buf, sizeof(t));
+        return ret;
+    }
+};
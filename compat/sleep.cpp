@@ -0,0 +1,85 @@
+#include "sleep.hpp"
+
+#ifdef _WIN32
+
+#include <mmsystem.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#   define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace {
+
+// how long before the deadline to stop sleeping and spin instead
+constexpr long long spin_nsecs = 150000;
+
+// one per thread, a waitable timer can't be waited on by two at once
+struct waitable_timer final
+{
+    HANDLE handle = nullptr;
+    bool period_set = false;
+
+    waitable_timer()
+    {
+        // Windows 10 1803 and later
+        handle = CreateWaitableTimerExW(nullptr, nullptr,
+                                        CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS);
+        // without it Sleep() is only as good as the system timer
+        if (!handle)
+            period_set = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+
+    ~waitable_timer()
+    {
+        if (handle)
+            CloseHandle(handle);
+        if (period_set)
+            (void) timeEndPeriod(1);
+    }
+
+    waitable_timer(const waitable_timer&) = delete;
+    waitable_timer& operator=(const waitable_timer&) = delete;
+
+    void sleep_nsecs(long long nsecs)
+    {
+        if (handle)
+        {
+            // negative is relative, in 100 ns units. absolute due times are
+            // on the wall clock, not on Timer's, so `deadline' stays ours
+            // and the caller looks at the clock again after waking.
+            LARGE_INTEGER due;
+            due.QuadPart = -(nsecs / 100);
+
+            if (due.QuadPart < 0 &&
+                SetWaitableTimer(handle, &due, 0, nullptr, nullptr, FALSE) &&
+                WaitForSingleObject(handle, INFINITE) == WAIT_OBJECT_0)
+                return;
+        }
+
+        // at least 1 ms, even if that's late. spinning for longer is worse.
+        const long long ms = nsecs / 1000000;
+        Sleep(DWORD(ms > 1 ? ms : 1));
+    }
+};
+
+} // ns
+
+void portable::sleep_until_nsecs(long long deadline)
+{
+    static thread_local waitable_timer timer;
+
+    for (;;)
+    {
+        const long long left = deadline - Timer::now_nsecs();
+
+        if (left <= 0)
+            break;
+        else if (left > spin_nsecs)
+            timer.sleep_nsecs(left - spin_nsecs);
+        else
+            YieldProcessor();
+    }
+}
+
+#endif
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "export.hpp"
+#include "timer.hpp"
+
 #ifdef _WIN32
 #   include <windows.h>
 #else
 #   include <unistd.h>
+#   include <time.h>
+#   include <cerrno>
 #endif
 
 namespace portable
@@ -21,4 +26,40 @@ namespace portable
             usleep(unsigned(milliseconds) * 1000U); // takes microseconds
     }
 #endif
+
+    // sleeps until an absolute Timer::now_nsecs() reading
+#if defined __linux__
+    inline void sleep_until_nsecs(long long deadline)
+    {
+        // same clock as Timer
+        timespec ts;
+        ts.tv_sec = time_t(deadline / 1000000000);
+        ts.tv_nsec = long(deadline % 1000000000);
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+            (void)0;
+    }
+#elif defined _WIN32
+    // a high-resolution waitable timer, or Sleep() where there's none.
+    // only spins through the last ~150 us either way.
+    OTR_COMPAT_EXPORT void sleep_until_nsecs(long long deadline);
+#else
+    inline void sleep_until_nsecs(long long deadline)
+    {
+        for (;;)
+        {
+            const long long left = deadline - Timer::now_nsecs();
+
+            if (left <= 0)
+                break;
+
+            timespec ts;
+            ts.tv_sec = time_t(left / 1000000000);
+            ts.tv_nsec = long(left % 1000000000);
+
+            if (nanosleep(&ts, nullptr) == 0)
+                break;
+        }
+    }
+#endif
 }
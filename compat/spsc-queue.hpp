@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// bounded wait-free queue for exactly one producer and one consumer thread.
+// capacity gets rounded up to a power of two.
+
+template<typename t>
+class spsc_queue final
+{
+    static unsigned round_up(unsigned x)
+    {
+        unsigned ret = 1;
+        while (ret < x)
+            ret <<= 1;
+        return ret;
+    }
+
+    const unsigned mask;
+    std::unique_ptr<t[]> buf;
+
+    alignas(64) std::atomic<unsigned> head { 0 }; // consumer
+    alignas(64) std::atomic<unsigned> tail { 0 }; // producer
+
+public:
+    explicit spsc_queue(unsigned capacity) :
+        mask(round_up(capacity < 2 ? 2 : capacity) - 1),
+        buf(std::make_unique<t[]>(mask + 1))
+    {}
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    unsigned capacity() const { return mask + 1; }
+
+    // producer side. returns false when full.
+    bool push(const t& value)
+    {
+        const unsigned tail_ = tail.load(std::memory_order_relaxed);
+
+        if (tail_ - head.load(std::memory_order_acquire) > mask)
+            return false;
+
+        buf[tail_ & mask] = value;
+        tail.store(tail_ + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // consumer side. returns false when empty.
+    bool pop(t& value)
+    {
+        const unsigned head_ = head.load(std::memory_order_relaxed);
+
+        if (head_ == tail.load(std::memory_order_acquire))
+            return false;
+
+        value = buf[head_ & mask];
+        head.store(head_ + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
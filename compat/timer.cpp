@@ -24,8 +24,32 @@ void Timer::start()
 
 // common
 
+std::atomic<long long> Timer::virtual_nsecs(-1);
+
+void Timer::set_virtual_clock(long long nsecs)
+{
+    virtual_nsecs.store(nsecs < 0 ? 0 : nsecs, std::memory_order_relaxed);
+}
+
+void Timer::use_system_clock()
+{
+    virtual_nsecs.store(-1, std::memory_order_relaxed);
+}
+
 void Timer::gettime(timespec* state)
 {
+    const long long virt = virtual_nsecs.load(std::memory_order_relaxed);
+
+    if (unlikely(virt >= 0))
+    {
+        using t_s = decltype(state->tv_sec);
+        using t_ns = decltype(state->tv_nsec);
+
+        state->tv_sec = t_s(virt / 1000000000);
+        state->tv_nsec = t_ns(virt % 1000000000);
+        return;
+    }
+
 #if defined(_WIN32) || defined(__MACH__)
     otr_clock_gettime(state);
 #elif defined CLOCK_MONOTONIC
@@ -50,6 +74,13 @@ long long Timer::conv_nsecs(const timespec& cur) const
     return (cur.tv_sec - state.tv_sec) * 1000000000LL + (cur.tv_nsec - state.tv_nsec);
 }
 
+long long Timer::now_nsecs()
+{
+    timespec cur{};
+    gettime(&cur);
+    return cur.tv_sec * 1000000000LL + cur.tv_nsec;
+}
+
 // microseconds
 
 double Timer::elapsed_usecs() const
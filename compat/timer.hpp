@@ -18,6 +18,7 @@
 #endif
 
 #include <ctime>
+#include <atomic>
 
 #include "time.hpp"
 #include "util.hpp"
@@ -35,6 +36,8 @@ class OTR_COMPAT_EXPORT Timer final
 
     static void gettime(struct timespec* state);
 
+    static std::atomic<long long> virtual_nsecs;
+
     using ns = time_units::ns;
 public:
     Timer();
@@ -60,6 +63,14 @@ public:
         return false;
     }
 
+    // monotonic clock reading. comparable across threads and modules.
+    static long long now_nsecs();
+
+    // for offline replay. makes every timer in the process read `nsecs'
+    // rather than the system clock, until use_system_clock() is called.
+    static void set_virtual_clock(long long nsecs);
+    static void use_system_clock();
+
     long long elapsed_nsecs() const;
     double elapsed_usecs() const;
     double elapsed_ms() const;
@@ -56,7 +56,9 @@ void cv_video_widget::update_image(const cv::Mat& frame)
 
         const cv::Mat& img = *img_;
 
-        texture = QImage((const unsigned char*) img.data, w, h, QImage::Format_ARGB32);
+        // the buffers above only change along with the size
+        if (texture.constBits() != img.data || texture.width() != w || texture.height() != h)
+            texture = QImage((const unsigned char*) img.data, w, h, QImage::Format_ARGB32);
     }
 }
 
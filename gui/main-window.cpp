@@ -117,6 +117,42 @@ MainWindow::MainWindow() :
             ui.iconcomboFilter->addItem(x->icon, x->name);
     }
 
+    // protocols running alongside the selected one
+    {
+        for (std::shared_ptr<dylib>& x : modules.protocols())
+        {
+            QAction* action = extra_protocols_menu.addAction(x->icon, x->name);
+            action->setCheckable(true);
+            const QString name = x->name;
+            connect(action, &QAction::triggered, this, [this, name](bool enable) { set_extra_protocol(name, enable); });
+        }
+
+        connect(&extra_protocols_menu, &QMenu::aboutToShow, this, [this]() { refresh_extra_protocols_menu(); });
+        ui.btnExtraProtocols->setMenu(&extra_protocols_menu);
+    }
+
+    // modules new since the last start have no icon yet. they get one
+    // once the window's up.
+    QTimer::singleShot(0, this, [this]() {
+        if (!modules.load_icons())
+            return;
+
+        for (int i = 0; i < modules.trackers().size(); i++)
+            ui.iconcomboTrackerSource->setItemIcon(i, modules.trackers()[i]->icon);
+
+        // one action per protocol, same order
+        const QList<QAction*> actions = extra_protocols_menu.actions();
+
+        for (int i = 0; i < modules.protocols().size(); i++)
+        {
+            ui.iconcomboProtocol->setItemIcon(i, modules.protocols()[i]->icon);
+            actions[i]->setIcon(modules.protocols()[i]->icon);
+        }
+
+        for (int i = 0; i < modules.filters().size(); i++)
+            ui.iconcomboFilter->setItemIcon(i, modules.filters()[i]->icon);
+    });
+
     // timers
     connect(&config_list_timer, &QTimer::timeout, this, [this]() { refresh_config_list(); });
     connect(&pose_update_timer, SIGNAL(timeout()), this, SLOT(show_pose()), Qt::DirectConnection);
@@ -315,7 +351,7 @@ void MainWindow::die_on_config_not_writable()
 bool MainWindow::maybe_die_on_config_not_writable(const QString& current, QStringList* ini_list_)
 {
     const bool writable =
-        group::with_settings_object([&](QSettings& s) {
+        group::with_settings_object([&](const QSettings& s) {
             return s.isWritable();
         });
 
@@ -366,6 +402,42 @@ void MainWindow::set_working_directory()
     QDir::setCurrent(OPENTRACK_BASE_PATH);
 }
 
+std::vector<std::shared_ptr<dylib>> MainWindow::extra_protocols()
+{
+    std::vector<std::shared_ptr<dylib>> ret;
+
+    for (const QString& name : static_cast<QList<QString>>(m.extra_protocol_dlls))
+        for (std::shared_ptr<dylib>& x : modules.protocols())
+            if (x->name == name)
+                ret.push_back(x);
+
+    return ret;
+}
+
+void MainWindow::refresh_extra_protocols_menu()
+{
+    const QList<QString> enabled = m.extra_protocol_dlls;
+    const QString primary = ui.iconcomboProtocol->currentText();
+
+    for (QAction* action : extra_protocols_menu.actions())
+    {
+        action->setChecked(enabled.contains(action->text()) && action->text() != primary);
+        action->setEnabled(action->text() != primary);
+    }
+}
+
+void MainWindow::set_extra_protocol(const QString& name, bool enable)
+{
+    QList<QString> enabled = m.extra_protocol_dlls;
+
+    enabled.removeAll(name);
+    if (enable)
+        enabled.append(name);
+
+    m.extra_protocol_dlls = enabled;
+    save_modules();
+}
+
 void MainWindow::save_modules()
 {
     qDebug() << "save modules";
@@ -401,6 +473,7 @@ void MainWindow::make_copied_config()
     {
         const QString new_name = group::ini_combine(name);
         (void) QFile::remove(new_name);
+        group::flush();
         QFile::copy(cur, new_name);
 
         if (!refresh_config_list())
@@ -502,7 +575,7 @@ void MainWindow::start_tracker_()
         display_pose(p, p);
     }
 
-    work = std::make_shared<Work>(pose, ev, ui.video_frame, current_tracker(), current_protocol(), current_filter());
+    work = std::make_shared<Work>(pose, ev, ui.video_frame, current_tracker(), current_protocol(), current_filter(), extra_protocols());
 
     if (!work->is_ok())
     {
@@ -538,6 +611,7 @@ void MainWindow::stop_tracker_()
 
     pose_update_timer.stop();
     ui.pose_display->rotate_sync(0,0,0, 0,0,0);
+    ui.pose_display->setToolTip(QString());
 
     if (pTrackerDialog)
         pTrackerDialog->unregister_tracker();
@@ -613,6 +687,8 @@ void MainWindow::show_pose()
     work->tracker->raw_and_mapped_pose(mapped, raw);
 
     display_pose(mapped, raw);
+
+    ui.pose_display->setToolTip(work->tracker->latency_report());
 }
 
 template<typename t, typename F>
@@ -653,7 +729,7 @@ template<typename t>
 bool MainWindow::mk_dialog(std::shared_ptr<dylib> lib, std::unique_ptr<t>& d)
 {
     const bool just_created = mk_window_common(d, [&]() -> t* {
-        if (lib && lib->Dialog)
+        if (lib && lib->load())
             return reinterpret_cast<t*>(lib->Dialog());
         return nullptr;
     });
@@ -690,7 +766,7 @@ void MainWindow::show_filter_settings()
 
 void MainWindow::show_options_dialog()
 {
-    if (mk_window(options_widget, [&](bool flag) -> void { set_keys_enabled(!flag); }))
+    if (mk_window(options_widget, [&](bool flag) -> void { set_keys_enabled(!flag); }, modules.extensions()))
     {
         connect(options_widget.get(), &OptionsDialog::closing, this, &MainWindow::register_shortcuts);
     }
@@ -63,6 +63,7 @@ class MainWindow : public QMainWindow, private State
 
     process_detector_worker det;
     QMenu profile_menu;
+    QMenu extra_protocols_menu;
 
     QAction menu_action_header, menu_action_show, menu_action_exit,
             menu_action_tracker, menu_action_filter, menu_action_proto,
@@ -80,6 +81,9 @@ class MainWindow : public QMainWindow, private State
     {
         return modules.filters().value(ui.iconcomboFilter->currentIndex(), nullptr);
     }
+    std::vector<std::shared_ptr<dylib>> extra_protocols();
+    void refresh_extra_protocols_menu();
+    void set_extra_protocol(const QString& name, bool enable);
 
     void update_button_state(bool running, bool inertialp);
     void display_pose(const double* mapped, const double* raw);
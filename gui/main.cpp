@@ -197,6 +197,9 @@ main(int argc, char** argv)
 
        app.exit(0);
 
+       // settings get written in the background
+       group::flush();
+
        qDebug() << "exit: window";
     }
     while (false);
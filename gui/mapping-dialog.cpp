@@ -64,6 +64,13 @@ MapWidget::MapWidget(Mappings& m) : m(m), widgets{}
     tie_setting(s.a_z.clamp_x_, ui.max_z_translation);
 
     tie_setting(s.a_pitch.clamp_y_, ui.max_pitch_output);
+
+    tie_setting(s.a_yaw.curve, ui.yaw_curve);
+    tie_setting(s.a_pitch.curve, ui.pitch_curve);
+    tie_setting(s.a_roll.curve, ui.roll_curve);
+    tie_setting(s.a_x.curve, ui.x_curve);
+    tie_setting(s.a_y.curve, ui.y_curve);
+    tie_setting(s.a_z.curve, ui.z_curve);
 }
 
 void MapWidget::load()
@@ -103,6 +110,12 @@ void MapWidget::load()
         for (a y : { a::t30, a::t20, a::t15, a::t10, a::t100 })
             x->addItem(QStringLiteral("%1 cm").arg(int(y)), y);
 
+    for (QComboBox* x : { ui.yaw_curve, ui.pitch_curve, ui.roll_curve, ui.x_curve, ui.y_curve, ui.z_curve })
+    {
+        x->addItem(tr("Sampled"), axis_opts::curve_sampled);
+        x->addItem(tr("Monotone"), axis_opts::curve_monotone);
+    }
+
     // XXX TODO add tie_setting overload for spline_widget!!! -sh 20171020
 
     for (int i = 0; qfcs[i].qfc; i++)
@@ -159,8 +172,8 @@ void MapWidget::refresh_tab()
 
     if (likely(idx >= 0 && idx < 6))
     {
-        widgets[idx][0]->repaint();
-        widgets[idx][1]->repaint();
+        widgets[idx][0]->update_last_value();
+        widgets[idx][1]->update_last_value();
     }
     else
         qDebug() << "map-widget: bad index" << idx;
@@ -170,15 +183,12 @@ void MapWidget::save_dialog()
 {
     s.b_map->save();
 
-    for (int i = 0; i < 6; i++)
+    m.forall([&](Map& s)
     {
-        m.forall([&](Map& s)
-        {
-            s.spline_main.save();
-            s.spline_alt.save();
-            s.opts.b_mapping_window->save();
-        });
-    }
+        s.spline_main.save();
+        s.spline_alt.save();
+        s.opts.b_mapping_window->save();
+    });
 }
 
 void MapWidget::invalidate_dialog()
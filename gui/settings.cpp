@@ -39,11 +39,21 @@ void OptionsDialog::set_disable_translation_state(bool value)
     });
 }
 
-OptionsDialog::OptionsDialog(std::function<void(bool)> pause_keybindings) :
+OptionsDialog::OptionsDialog(std::function<void(bool)> pause_keybindings, const Modules::dylib_list& extensions) :
+    ext_settings(event_handler::make_settings()),
     pause_keybindings(pause_keybindings)
 {
     ui.setupUi(this);
 
+    // unchecked extensions don't get loaded, from the next time tracking starts
+    for (const std::shared_ptr<dylib>& lib : extensions)
+    {
+        auto item = new QListWidgetItem(lib->name, ui.extensions);
+        item->setData(Qt::UserRole, lib->module_name);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(event_handler::is_enabled(ext_settings, lib->module_name) ? Qt::Checked : Qt::Unchecked);
+    }
+
     connect(ui.buttonBox, SIGNAL(accepted()), this, SLOT(doOK()));
     connect(ui.buttonBox, SIGNAL(rejected()), this, SLOT(doCancel()));
 
@@ -52,6 +62,16 @@ OptionsDialog::OptionsDialog(std::function<void(bool)> pause_keybindings) :
 
     tie_setting(main.center_at_startup, ui.center_at_startup);
 
+    {
+        using r = main_settings::pipeline_rate;
+
+        ui.pipeline_rate->addItem(tr("Adaptive"), r::rate_adaptive);
+        for (r x : { r::rate_250, r::rate_500, r::rate_1000 })
+            ui.pipeline_rate->addItem(tr("%1 Hz").arg(int(x)), x);
+
+        tie_setting(main.pipeline_hz, ui.pipeline_rate);
+    }
+
     tie_setting(main.tcomp_p, ui.tcomp_enable);
 
     tie_setting(main.tcomp_disable_tx, ui.tcomp_tx_disable);
@@ -91,6 +111,16 @@ OptionsDialog::OptionsDialog(std::function<void(bool)> pause_keybindings) :
 
     tie_setting(main.neck_enable, ui.neck_enable);
 
+    ui.predict_model->addItem(tr("Constant velocity"));
+    ui.predict_model->addItem(tr("Constant acceleration"));
+
+    tie_setting(main.predict_enable, ui.predict_enable);
+    tie_setting(main.predict_model, ui.predict_model);
+    tie_setting(main.predict_auto, ui.predict_auto);
+    tie_setting(main.predict_ms, ui.predict_ms);
+    tie_setting(main.predict_max_rot, ui.predict_max_rot);
+    tie_setting(main.predict_max_pos, ui.predict_max_pos);
+
     const bool is_translation_disabled = group::with_global_settings_object([] (QSettings& s) {
         return s.value("disable-translation", false).toBool();
     });
@@ -211,6 +241,12 @@ void OptionsDialog::doOK()
         return;
 
     main.b->save();
+    for (int i = 0; i < ui.extensions->count(); i++)
+    {
+        const QListWidgetItem* item = ui.extensions->item(i);
+        ext_settings->store_kv(item->data(Qt::UserRole).toString(), item->checkState() == Qt::Checked);
+    }
+    ext_settings->save();
     ui.game_detector->save();
     set_disable_translation_state(ui.disable_translation->isChecked());
     emit closing();
@@ -226,6 +262,11 @@ void OptionsDialog::doCancel()
 
     main.b->reload();
     ui.game_detector->revert();
+    for (int i = 0; i < ui.extensions->count(); i++)
+    {
+        QListWidgetItem* item = ui.extensions->item(i);
+        item->setCheckState(event_handler::is_enabled(ext_settings, item->data(Qt::UserRole).toString()) ? Qt::Checked : Qt::Unchecked);
+    }
     emit closing();
 }
 
@@ -2,6 +2,8 @@
 
 #include "ui_settings-dialog.h"
 #include "logic/shortcuts.h"
+#include "logic/extensions.hpp"
+#include "api/plugin-support.hpp"
 #include <QObject>
 #include <QDialog>
 #include <QWidget>
@@ -13,9 +15,10 @@ class OptionsDialog : public QDialog
 signals:
     void closing();
 public:
-    OptionsDialog(std::function<void(bool)> pause_keybindings);
+    OptionsDialog(std::function<void(bool)> pause_keybindings, const Modules::dylib_list& extensions);
 private:
     main_settings main;
+    options::bundle ext_settings;
     std::function<void(bool)> pause_keybindings;
     Ui::options_dialog ui;
     void closeEvent(QCloseEvent *) override;
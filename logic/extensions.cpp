@@ -21,31 +21,37 @@ static constexpr struct event_type_mapping
     { &IExtension::process_finished, ext_mask::on_finished, ext_ord::ev_finished, },
 };
 
-bool event_handler::is_enabled(const QString& name)
+bundle event_handler::make_settings()
 {
-#if 1
-    return true;
-#else
-    if (!ext_bundle->contains(name))
-        return false;
+    return make_bundle("extensions");
+}
 
-    return ext_bundle->get<bool>(name);
-#endif
+bool event_handler::is_enabled(const bundle& b, const QString& module_name)
+{
+    // as before there was a setting, and for new modules
+    if (!b->contains(module_name))
+        return true;
+
+    return b->get<bool>(module_name);
 }
 
-event_handler::event_handler(Modules::dylib_list const& extensions) : ext_bundle(make_bundle("extensions"))
+event_handler::event_handler(Modules::dylib_list const& extensions) : ext_bundle(make_settings())
 {
     for (std::shared_ptr<dylib> const& lib : extensions)
     {
+        if (!is_enabled(ext_bundle, lib->module_name))
+            continue;
+
+        // disabled extensions don't get loaded at all
+        if (!lib->load())
+            continue;
+
         std::shared_ptr<IExtension> ext(reinterpret_cast<IExtension*>(lib->Constructor()));
         std::shared_ptr<IExtensionDialog> dlg(reinterpret_cast<IExtensionDialog*>(lib->Dialog()));
         std::shared_ptr<Metadata> m(reinterpret_cast<Metadata*>(lib->Meta()));
 
         const ext_mask mask = ext->hook_types();
 
-        if (!is_enabled(lib->module_name))
-            continue;
-
 #if 1
         qDebug() << "extension" << lib->module_name << "mask" << (void*)mask;
 #endif
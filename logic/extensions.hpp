@@ -26,12 +26,14 @@ struct OTR_LOGIC_EXPORT event_handler final
     void run_events(event_ordinal k, Pose& pose);
     event_handler(Modules::dylib_list const& extensions);
 
+    // extensions are on unless they're unchecked in the options dialog
+    static options::bundle make_settings();
+    static bool is_enabled(const options::bundle& b, const QString& module_name);
+
 private:
     using ext_list = std::vector<extension>;
     std::array<ext_list, IExtension::event_count> extensions_for_event;
 
     options::bundle ext_bundle;
-
-    bool is_enabled(const QString& name);
 };
 
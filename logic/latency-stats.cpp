@@ -0,0 +1,202 @@
+#include "latency-stats.hpp"
+
+#include <cstdio>
+#include <algorithm>
+
+#include <QFile>
+#include <QTextStream>
+
+using namespace latency_impl;
+
+histogram::histogram()
+{
+    reset();
+}
+
+unsigned histogram::bucket_for(unsigned long long us)
+{
+    if (us < sub_count)
+        return unsigned(us);
+
+    us = std::min(us, (2ull << max_msb) - 1);
+
+    unsigned msb = 0;
+    while ((us >> (msb + 1)) != 0)
+        msb++;
+
+    const unsigned sub = unsigned(us >> (msb - sub_bits)) & (sub_count - 1);
+
+    return (msb - sub_bits + 1) * sub_count + sub;
+}
+
+unsigned long long histogram::bucket_start(unsigned idx)
+{
+    if (idx < sub_count)
+        return idx;
+
+    const unsigned msb = idx / sub_count + sub_bits - 1;
+    const unsigned sub = idx % sub_count;
+
+    return (unsigned long long)(sub_count + sub) << (msb - sub_bits);
+}
+
+void histogram::add(long long nsecs)
+{
+    if (nsecs < 0)
+        nsecs = 0;
+
+    const unsigned idx = bucket_for((unsigned long long) nsecs / 1000);
+    counts[idx].store(counts[idx].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (nsecs > max_ns.load(std::memory_order_relaxed))
+        max_ns.store(nsecs, std::memory_order_relaxed);
+}
+
+histogram::summary histogram::get() const
+{
+    unsigned buf[bucket_count];
+    unsigned total = 0;
+
+    for (unsigned k = 0; k < bucket_count; k++)
+    {
+        buf[k] = counts[k].load(std::memory_order_relaxed);
+        total += buf[k];
+    }
+
+    summary ret {};
+    ret.count = total;
+    ret.max = max_ns.load(std::memory_order_relaxed) * 1e-6;
+
+    if (total == 0)
+        return ret;
+
+    auto quantile = [&](double q) {
+        const unsigned rank = std::max(1u, unsigned(q * total + .5));
+        unsigned cnt = 0;
+        for (unsigned k = 0; k < bucket_count; k++)
+        {
+            cnt += buf[k];
+            if (cnt >= rank)
+            {
+                // bucket midpoint
+                const double lo = bucket_start(k);
+                const double hi = k + 1 < bucket_count ? bucket_start(k + 1) : lo;
+                return std::min(ret.max, (lo + hi) * .5e-3);
+            }
+        }
+        return ret.max;
+    };
+
+    ret.p50 = quantile(.5);
+    ret.p99 = quantile(.99);
+
+    return ret;
+}
+
+void histogram::reset()
+{
+    for (std::atomic<unsigned>& x : counts)
+        x.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+}
+
+void latency_stats::reset()
+{
+    for (histogram& h : stages)
+        h.reset();
+    wakeup.reset();
+    overruns.store(0, std::memory_order_relaxed);
+}
+
+const char* latency_stats::stage_name(stage k)
+{
+    static constexpr const char* names[stage_count] =
+    {
+        "tracker",
+        "transform",
+        "filter",
+        "mapping",
+        "protocol",
+        "total",
+    };
+
+    return k < stage_count ? names[k] : "";
+}
+
+static QString format_line(const QString& name, const latency_stats::summary& s, const char* suffix = "")
+{
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "%-9s p50 %7.3f  p99 %7.3f  max %7.3f ms%s\n",
+                  name.toLocal8Bit().constData(), s.p50, s.p99, s.max, suffix);
+    return buf;
+}
+
+QString latency_stats::report(const std::vector<named_summary>& extra) const
+{
+    QString ret;
+
+    for (unsigned k = 0; k < stage_count; k++)
+    {
+        const summary s = get(stage(k));
+
+        if (s.count == 0)
+            continue;
+
+        ret += format_line(stage_name(stage(k)), s);
+    }
+
+    const summary w = get_wakeup();
+
+    if (w.count > 0)
+    {
+        char missed[32];
+        std::snprintf(missed, sizeof(missed), ", %u missed", get_overruns());
+        ret += format_line(QStringLiteral("jitter"), w, missed);
+    }
+
+    for (const named_summary& x : extra)
+    {
+        if (x.s.count == 0)
+            continue;
+
+        char superseded[32];
+        std::snprintf(superseded, sizeof(superseded), ", %u superseded", x.dropped);
+        ret += format_line(x.name, x.s, superseded);
+    }
+
+    return ret.trimmed();
+}
+
+static void write_row(QTextStream& out, const QString& name, const latency_stats::summary& s, unsigned dropped = 0)
+{
+    out << name << ','
+        << s.count << ','
+        << s.p50 << ','
+        << s.p99 << ','
+        << s.max << ','
+        << dropped << '\n';
+}
+
+bool latency_stats::dump(const QString& filename, const std::vector<named_summary>& extra) const
+{
+    QFile f(filename);
+
+    if (!f.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+        return false;
+
+    QTextStream out(&f);
+
+    // dropped: periods missed for jitter, poses superseded for protocols
+    out << "stage,count,p50_ms,p99_ms,max_ms,dropped\n";
+
+    for (unsigned k = 0; k < stage_count; k++)
+        write_row(out, stage_name(stage(k)), get(stage(k)));
+
+    write_row(out, QStringLiteral("jitter"), get_wakeup(), get_overruns());
+
+    for (const named_summary& x : extra)
+        write_row(out, x.name, x.s, x.dropped);
+
+    out.flush();
+    return f.error() == QFile::NoError;
+}
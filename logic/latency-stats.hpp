@@ -0,0 +1,96 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "export.hpp"
+
+#include <atomic>
+#include <vector>
+
+#include <QString>
+
+namespace latency_impl {
+
+// log-linear histogram of durations in microseconds, eight buckets per
+// power of two. single writer, any number of readers, no locking.
+class OTR_LOGIC_EXPORT histogram final
+{
+    static constexpr unsigned sub_bits = 3, sub_count = 1u << sub_bits;
+    static constexpr unsigned max_msb = 34;
+    static constexpr unsigned bucket_count = (max_msb - sub_bits + 2) * sub_count;
+
+    std::atomic<unsigned> counts[bucket_count];
+    std::atomic<long long> max_ns;
+
+    static unsigned bucket_for(unsigned long long us);
+    static unsigned long long bucket_start(unsigned idx);
+
+public:
+    struct summary
+    {
+        unsigned count;
+        double p50, p99, max; // milliseconds
+    };
+
+    histogram();
+    void add(long long nsecs);
+    summary get() const;
+    void reset();
+};
+
+} // ns latency_impl
+
+struct OTR_LOGIC_EXPORT latency_stats final
+{
+    // each stage spans two consecutive pose timestamps
+    enum stage : unsigned
+    {
+        st_tracker,     // capture -> read by the pipeline
+        st_transform,   // ev_raw -> ev_before_filter
+        st_filter,      // ev_before_filter -> ev_before_mapping
+        st_mapping,     // ev_before_mapping -> ev_finished
+        st_protocol,    // ev_finished -> handed to the output threads
+        st_total,       // capture -> handed to the output threads
+
+        stage_count,
+    };
+
+    using histogram = latency_impl::histogram;
+    using summary = histogram::summary;
+    // measured elsewhere, such as per-protocol send latency. `dropped'
+    // counts what was never measured, such as poses superseded unsent.
+    struct named_summary
+    {
+        QString name;
+        summary s;
+        unsigned dropped;
+    };
+
+    void add(stage k, long long nsecs) { stages[k].add(nsecs); }
+    summary get(stage k) const { return stages[k].get(); }
+    void reset();
+
+    // fixed-rate scheduling. lateness of each wakeup past its deadline,
+    // and how many periods were skipped because an iteration ran long.
+    void add_wakeup(long long nsecs) { wakeup.add(nsecs); }
+    void add_overruns(unsigned n) { overruns.fetch_add(n, std::memory_order_relaxed); }
+    summary get_wakeup() const { return wakeup.get(); }
+    unsigned get_overruns() const { return overruns.load(std::memory_order_relaxed); }
+
+    static const char* stage_name(stage k);
+
+    // one line per stage, for display
+    QString report(const std::vector<named_summary>& extra = std::vector<named_summary>()) const;
+    // csv with one row per stage
+    bool dump(const QString& filename, const std::vector<named_summary>& extra = std::vector<named_summary>()) const;
+
+private:
+    histogram stages[stage_count];
+    histogram wakeup;
+    std::atomic<unsigned> overruns { 0 };
+};
@@ -42,7 +42,14 @@ main_settings::main_settings() :
     key_zero_press1(b, "zero-press"),
     key_zero_press2(b, "zero-press-alt"),
     tracklogging_enabled(b, "tracklogging-enabled", false),
-    tracklogging_filename(b, "tracklogging-filename", QString())
+    tracklogging_filename(b, "tracklogging-filename", QString()),
+    pipeline_hz(b, "pipeline-rate", rate_adaptive),
+    predict_enable(b, "prediction-enable", false),
+    predict_auto(b, "prediction-auto-latency", true),
+    predict_model(b, "prediction-model", 0),
+    predict_ms(b, "prediction-latency-ms", 0),
+    predict_max_rot(b, "prediction-max-rotation", 5),
+    predict_max_pos(b, "prediction-max-translation", 2)
 {
 }
 
@@ -50,7 +57,8 @@ module_settings::module_settings() :
     b(make_bundle("modules")),
     tracker_dll(b, "tracker-dll", "PointTracker 1.1"),
     filter_dll(b, "filter-dll", "Accela"),
-    protocol_dll(b, "protocol-dll", "freetrack 2.0 Enhanced")
+    protocol_dll(b, "protocol-dll", "freetrack 2.0 Enhanced"),
+    extra_protocol_dlls(b, "extra-protocol-dlls", QList<QString>())
 {
 }
 
@@ -28,11 +28,23 @@ struct OTR_LOGIC_EXPORT module_settings
 {
     bundle b;
     value<QString> tracker_dll, filter_dll, protocol_dll;
+    // sent the same output as protocol_dll
+    value<QList<QString>> extra_protocol_dlls;
     module_settings();
 };
 
 struct OTR_LOGIC_EXPORT main_settings final
 {
+    // pipeline iterations per second. adaptive runs every 4 ms or
+    // earlier when the tracker has a new frame.
+    enum pipeline_rate
+    {
+        rate_adaptive = 0,
+        rate_250 = 250,
+        rate_500 = 500,
+        rate_1000 = 1000,
+    };
+
     bundle b, b_map;
     axis_opts a_x, a_y, a_z;
     axis_opts a_yaw, a_pitch, a_roll;
@@ -55,6 +67,9 @@ struct OTR_LOGIC_EXPORT main_settings final
     key_opts key_zero_press1, key_zero_press2;
     value<bool> tracklogging_enabled;
     value<QString> tracklogging_filename;
+    value<pipeline_rate> pipeline_hz;
+    value<bool> predict_enable, predict_auto;
+    value<int> predict_model, predict_ms, predict_max_rot, predict_max_pos;
 
     main_settings();
 };
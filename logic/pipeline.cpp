@@ -13,8 +13,8 @@
  */
 
 #include "compat/nan.hpp"
-#include "compat/sleep.hpp"
 #include "compat/util.hpp"
+#include "compat/sleep.hpp"
 
 #include "pipeline.hpp"
 
@@ -39,6 +39,17 @@ pipeline::pipeline(Mappings& m, runtime_libraries& libs, event_handler& ev, Trac
     libs(libs),
     logger(logger)
 {
+    // s.b and s.b_map are the same bundles the axis options live in
+    for (const bundle& b : { s.b, s.b_map })
+        connect(b.get(), &options::detail::bundle::changed,
+                this, [this]() { settings_dirty.store(true); },
+                Qt::DirectConnection);
+
+    if (libs.pProtocol)
+        outputs.push_back(std::make_unique<protocol_output>(libs.pProtocol, libs.protocol_name));
+
+    for (const runtime_libraries::extra_protocol& x : libs.pExtraProtocols)
+        outputs.push_back(std::make_unique<protocol_output>(x.proto, x.name));
 }
 
 pipeline::~pipeline()
@@ -47,9 +58,44 @@ pipeline::~pipeline()
     wait();
 }
 
-double pipeline::map(double pos, Map& axis)
+void pipeline::update_settings()
+{
+    for (unsigned i = 0; i < 6; i++)
+    {
+        const axis_opts& opts = m(i).opts;
+        settings_snapshot::axis& a = cs.axes[i];
+
+        a.zero = opts.zero;
+        a.src = opts.src;
+        a.invert = opts.invert;
+        a.altp = opts.altp;
+    }
+
+    cs.neck_z = s.neck_z;
+    cs.neck_enable = s.neck_enable;
+
+    cs.tcomp_p = s.tcomp_p;
+    cs.tcomp_disable_tx = s.tcomp_disable_tx;
+    cs.tcomp_disable_ty = s.tcomp_disable_ty;
+    cs.tcomp_disable_tz = s.tcomp_disable_tz;
+    cs.tcomp_disable_src_yaw = s.tcomp_disable_src_yaw;
+    cs.tcomp_disable_src_pitch = s.tcomp_disable_src_pitch;
+    cs.tcomp_disable_src_roll = s.tcomp_disable_src_roll;
+
+    cs.center_at_startup = s.center_at_startup;
+
+    cs.predict_enable = s.predict_enable;
+    cs.predict_auto = s.predict_auto;
+    cs.predict_model = s.predict_model;
+    cs.predict_ms = s.predict_ms;
+    cs.predict_max_rot = s.predict_max_rot;
+    cs.predict_max_pos = s.predict_max_pos;
+}
+
+double pipeline::map(double pos, unsigned i)
 {
-    bool altp = (pos < 0) && axis.opts.altp;
+    Map& axis = m(i);
+    bool altp = (pos < 0) && cs.axes[i].altp;
     axis.spline_main.set_tracking_active( !altp );
     axis.spline_alt.set_tracking_active( altp );
     auto& fc = altp ? axis.spline_alt : axis.spline_main;
@@ -114,10 +160,18 @@ void pipeline::logic()
     logger.write_dt();
     logger.reset_dt();
 
+    // cleared first, so a change while copying gets picked up next tick
+    if (settings_dirty.exchange(false))
+        update_settings();
+
     const bool center_ordered = get(f_center) && tracking_started;
     set(f_center, false);
     const bool own_center_logic = center_ordered && libs.pTracker->center();
 
+    using LS = latency_stats;
+
+    const long long t_start = Timer::now_nsecs();
+
     {
         Pose tmp;
         libs.pTracker->data(tmp);
@@ -128,12 +182,21 @@ void pipeline::logic()
                 newpose(i) = elide_nan(tmp(i), newpose(i));
     }
 
+    const long long t_raw = Timer::now_nsecs();
+    const long long t_capture = libs.pTracker->sample_time();
+    const bool fresh_sample = t_capture != 0 && t_capture != last_sample_time;
+
+    if (fresh_sample)
+    {
+        last_sample_time = t_capture;
+        latency.add(LS::st_tracker, t_raw - t_capture);
+    }
+
     Pose value, raw;
 
     for (int i = 0; i < 6; i++)
     {
-        auto& axis = m(i);
-        int k = axis.opts.src;
+        int k = cs.axes[i].src;
         if (k < 0 || k >= 6)
             value(i) = 0;
         else
@@ -184,7 +247,7 @@ void pipeline::logic()
 
         tracking_started &= !nanp;
 
-        if (tracking_started && s.center_at_startup)
+        if (tracking_started && cs.center_at_startup)
         {
             set(f_center, true);
         }
@@ -238,9 +301,9 @@ void pipeline::logic()
             // don't invert after t_compensate
             // inverting here doesn't break centering
 
-            if (m(i+3).opts.invert)
+            if (cs.axes[i+3].invert)
                 rot(i) = -rot(i);
-            if (m(i).opts.invert)
+            if (cs.axes[i].invert)
                 pos(i) = -pos(i);
         }
 
@@ -253,8 +316,13 @@ void pipeline::logic()
 
     ev.run_events(EV::ev_before_filter, value);
 
+    const long long t_before_filter = Timer::now_nsecs();
+    latency.add(LS::st_transform, t_before_filter - t_raw);
+
     logger.write_pose(value); // "corrected" - after various transformations to account for camera position
 
+    const Pose corrected = value;
+
     nanp |= is_nan(value);
 
     {
@@ -269,16 +337,44 @@ void pipeline::logic()
         }
     }
 
+    const Pose filtered = value;
+
     nanp |= is_nan(value);
 
+    if (center_ordered || nanp || !cs.predict_enable)
+        predictor.reset();
+    else
+    {
+        const long long now = Timer::now_nsecs();
+
+        // percentiles are too expensive to recompute every tick
+        if (cs.predict_auto && (measured_lead == 0 || predict_lead_timer.is_elapsed(secs_(1))))
+            measured_lead = latency.get(LS::st_total).p50 * 1e-3;
+
+        pose_predictor::params p;
+        p.kind = cs.predict_model == 1
+                 ? pose_predictor::constant_acceleration
+                 : pose_predictor::constant_velocity;
+        p.lead = cs.predict_ms * 1e-3 + (cs.predict_auto ? measured_lead : 0);
+        p.max_rot = cs.predict_max_rot;
+        p.max_pos = cs.predict_max_pos;
+
+        predictor.add(value, now);
+        value = predictor.predict(value, now, p);
+    }
+
+    ev.run_events(EV::ev_before_mapping, value);
+
+    const long long t_before_mapping = Timer::now_nsecs();
+    latency.add(LS::st_filter, t_before_mapping - t_before_filter);
+
     {
-        ev.run_events(EV::ev_before_mapping, value);
 
         euler_t neck, rel;
 
-        if (s.neck_enable)
+        if (cs.neck_enable)
         {
-            double nz = -s.neck_z;
+            double nz = -cs.neck_z;
 
             if (nz != 0)
             {
@@ -296,15 +392,15 @@ void pipeline::logic()
 
         // CAVEAT rotation only, due to tcomp
         for (int i = 3; i < 6; i++)
-            value(i) = map(value(i), m(i));
+            value(i) = map(value(i), i);
 
-        if (s.tcomp_p)
+        if (cs.tcomp_p)
         {
             const double tcomp_c[] =
             {
-                double(!s.tcomp_disable_src_yaw),
-                double(!s.tcomp_disable_src_pitch),
-                double(!s.tcomp_disable_src_roll),
+                double(!cs.tcomp_disable_src_yaw),
+                double(!cs.tcomp_disable_src_pitch),
+                double(!cs.tcomp_disable_src_roll),
             };
             const rmat R = euler_to_rmat(
                        euler_t(value(Yaw)   * d2r * tcomp_c[0],
@@ -314,9 +410,9 @@ void pipeline::logic()
             t_compensate(R,
                          euler_t(value(TX), value(TY), value(TZ)),
                          ret,
-                         s.tcomp_disable_tx,
-                         s.tcomp_disable_ty,
-                         s.tcomp_disable_tz);
+                         cs.tcomp_disable_tx,
+                         cs.tcomp_disable_ty,
+                         cs.tcomp_disable_tz);
 
             for (int i = 0; i < 3; i++)
                 rel(i) = ret(i) - value(i);
@@ -331,18 +427,16 @@ void pipeline::logic()
 
     // CAVEAT translation only, due to tcomp
     for (int i = 0; i < 3; i++)
-        value(i) = map(value(i), m(i));
+        value(i) = map(value(i), i);
 
     if (nanp)
     {
-        QMutexLocker foo(&mtx);
-
         value = output_pose;
         raw = raw_6dof;
 
         // for widget last value display
         for (int i = 0; i < 6; i++)
-            (void) map(raw_6dof(i), m(i));
+            (void) map(raw_6dof(i), i);
     }
 
     if (get(f_zero))
@@ -351,49 +445,160 @@ void pipeline::logic()
 
     // custom zero position
     for (int i = 0; i < 6; i++)
-        value(i) += m(i).opts.zero * (m(i).opts.invert ? -1 : 1);
+        value(i) += cs.axes[i].zero * (cs.axes[i].invert ? -1 : 1);
 
     ev.run_events(EV::ev_finished, value);
 
+    const long long t_finished = Timer::now_nsecs();
+    latency.add(LS::st_mapping, t_finished - t_before_mapping);
+
     if (!nanp)
-        libs.pProtocol->pose(value);
+    {
+        for (std::unique_ptr<protocol_output>& out : outputs)
+            out->pose(value, t_finished);
+
+        const long long t_done = Timer::now_nsecs();
+        latency.add(LS::st_protocol, t_done - t_finished);
+
+        if (fresh_sample)
+            latency.add(LS::st_total, t_done - t_capture);
+        // trackers not stamping their samples get measured from the data() call
+        else if (t_capture == 0)
+            latency.add(LS::st_total, t_done - t_start);
+    }
 
-    QMutexLocker foo(&mtx);
     output_pose = value;
     raw_6dof = raw;
 
+    {
+        pose_snapshot snap;
+        snap.raw = raw;
+        snap.corrected = corrected;
+        snap.filtered = filtered;
+        snap.mapped = value;
+        snap.time = Timer::now_nsecs();
+        published.store(snap);
+    }
+
     logger.write_pose(value); // "mapped"
 
     logger.reset_dt();
     logger.next_line();
 }
 
+void pipeline::log_header()
+{
+    static constexpr const char* posechannels[6] = { "TX", "TY", "TZ", "Yaw", "Pitch", "Roll" };
+    static constexpr const char* datachannels[5] = { "dt", "raw", "corrected", "filtered", "mapped" };
+    logger.write(datachannels[0]);
+    char buffer[128];
+    for (unsigned j = 1; j < 5; ++j)
+    {
+        for (unsigned i = 0; i < 6; ++i)
+        {
+            std::sprintf(buffer, "%s%s", datachannels[j], posechannels[i]);
+            logger.write(buffer);
+        }
+    }
+    logger.next_line();
+
+    logger.reset_dt();
+}
+
+void pipeline::finish()
+{
+    // filter may inhibit exact origin
+    const Pose p;
+    const long long now = Timer::now_nsecs();
+
+    for (std::unique_ptr<protocol_output>& out : outputs)
+    {
+        out->pose(p, now);
+        out->stop();
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        m(i).spline_main.set_tracking_active(false);
+        m(i).spline_alt.set_tracking_active(false);
+    }
+}
+
+void pipeline::offline_begin(bool header)
+{
+    latency.reset();
+
+    if (header)
+        log_header();
+    else
+        logger.reset_dt();
+}
+
+void pipeline::offline_end()
+{
+    finish();
+}
+
 void pipeline::run()
 {
 #if defined _WIN32
     const MMRESULT mmres = timeBeginPeriod(1);
 #endif
 
+    // stats are per tracking session
+    latency.reset();
+    log_header();
+
+    const int hz = s.pipeline_hz;
+
+    if (hz > 0)
+        run_fixed_rate(hz);
+    else
+        run_adaptive();
+
+    finish();
+
+#if defined _WIN32
+    if (mmres == 0)
+        (void) timeEndPeriod(1);
+#endif
+}
+
+void pipeline::run_fixed_rate(int hz)
+{
+    // iterations happen on absolute deadlines, so neither the time taken
+    // by logic() nor a late wakeup shifts the ones after it. new tracker
+    // frames are picked up on the next tick rather than waking us early.
+    const long long period = 1000000000LL / hz;
+    long long deadline = Timer::now_nsecs();
+
+    while (!isInterruptionRequested())
     {
-        static constexpr const char* posechannels[6] = { "TX", "TY", "TZ", "Yaw", "Pitch", "Roll" };
-        static constexpr const char* datachannels[5] = { "dt", "raw", "corrected", "filtered", "mapped" };
-        logger.write(datachannels[0]);
-        char buffer[128];
-        for (unsigned j = 1; j < 5; ++j)
+        logic();
+
+        deadline += period;
+
+        const long long now = Timer::now_nsecs();
+
+        if (now > deadline)
         {
-            for (unsigned i = 0; i < 6; ++i)
-            {
-                std::sprintf(buffer, "%s%s", datachannels[j], posechannels[i]);
-                logger.write(buffer);
-            }
+            // ran long. skip what we missed instead of bursting to catch up.
+            const long long missed = (now - deadline) / period + 1;
+            latency.add_overruns(unsigned(missed));
+            deadline += missed * period;
         }
-        logger.next_line();
-    }
 
-    logger.reset_dt();
+        portable::sleep_until_nsecs(deadline);
+        latency.add_wakeup(Timer::now_nsecs() - deadline);
+    }
+}
 
+void pipeline::run_adaptive()
+{
     t.start();
 
+    bool woken = false;
+
     while (!isInterruptionRequested())
     {
         logic();
@@ -401,14 +606,24 @@ void pipeline::run()
         constexpr ns const_sleep_ms(time_cast<ns>(ms(4)));
         const ns elapsed_nsecs = prog1(t.elapsed<ns>(), t.start());
 
-        if (backlog_time > secs_(3) || backlog_time < secs_(-3))
+        if (woken)
         {
-            qDebug() << "tracker: backlog interval overflow"
-                     << time_cast<ms>(backlog_time).count() << "ms";
-            backlog_time = backlog_time.zero();
+            // the tracker cut the last sleep short. start a new period
+            // from the wakeup rather than counting it as backlog.
+            woken = false;
+            backlog_time = elapsed_nsecs;
         }
+        else
+        {
+            if (backlog_time > secs_(3) || backlog_time < secs_(-3))
+            {
+                qDebug() << "tracker: backlog interval overflow"
+                         << time_cast<ms>(backlog_time).count() << "ms";
+                backlog_time = backlog_time.zero();
+            }
 
-        backlog_time += ns(elapsed_nsecs - const_sleep_ms);
+            backlog_time += ns(elapsed_nsecs - const_sleep_ms);
+        }
 
         const int sleep_time_ms = time_cast<ms>(clamp(const_sleep_ms - backlog_time,
                                                       ms::zero(), ms(10))).count();
@@ -419,34 +634,50 @@ void pipeline::run()
                  << "backlog" << time_cast<ms>(backlog_time).count();
 #endif
 
-        portable::sleep(sleep_time_ms);
+        // pull-only trackers never notify, so this is the old timed sleep for them
+        if (libs.pTracker->wait_for_new_sample(sleep_time_ms))
+        {
+            woken = true;
+            t.start();
+        }
     }
+}
 
-    // filter may inhibit exact origin
-    Pose p;
-    libs.pProtocol->pose(p);
+void pipeline::raw_and_mapped_pose(double* mapped, double* raw) const
+{
+    const pose_snapshot snap = published.load();
 
     for (int i = 0; i < 6; i++)
     {
-        m(i).spline_main.set_tracking_active(false);
-        m(i).spline_alt.set_tracking_active(false);
+        raw[i] = snap.raw(i);
+        mapped[i] = snap.mapped(i);
     }
+}
 
-#if defined _WIN32
-    if (mmres == 0)
-        (void) timeEndPeriod(1);
-#endif
+pose_snapshot pipeline::snapshot() const
+{
+    return published.load();
 }
 
-void pipeline::raw_and_mapped_pose(double* mapped, double* raw) const
+std::vector<latency_stats::named_summary> pipeline::output_latency() const
 {
-    QMutexLocker foo(&const_cast<pipeline&>(*this).mtx);
+    std::vector<latency_stats::named_summary> ret;
+    ret.reserve(outputs.size());
 
-    for (int i = 0; i < 6; i++)
-    {
-        raw[i] = raw_6dof(i);
-        mapped[i] = output_pose(i);
-    }
+    for (const std::unique_ptr<protocol_output>& out : outputs)
+        ret.push_back({ out->name(), out->get_latency(), out->get_superseded() });
+
+    return ret;
+}
+
+QString pipeline::latency_report() const
+{
+    return latency.report(output_latency());
+}
+
+bool pipeline::dump_latency(const QString& filename) const
+{
+    return latency.dump(filename, output_latency());
 }
 
 void pipeline::center() { set(f_center, true); }
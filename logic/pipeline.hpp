@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "compat/timer.hpp"
+#include "compat/seqlock.hpp"
 #include "api/plugin-support.hpp"
 #include "mappings.hpp"
 #include "compat/euler.hpp"
@@ -21,8 +22,10 @@
 #include "main-settings.hpp"
 #include "options/options.hpp"
 #include "tracklogger.hpp"
+#include "latency-stats.hpp"
+#include "pose-predictor.hpp"
+#include "protocol-output.hpp"
 
-#include <QMutex>
 #include <QThread>
 
 #include <atomic>
@@ -51,6 +54,40 @@ struct OTR_LOGIC_EXPORT bits
     bits();
 };
 
+// plain copy of the settings logic() reads, so that a tick doesn't take
+// the bundle lock and convert a QVariant for each of them. rebuilt on the
+// pipeline thread after a bundle emits changed().
+struct settings_snapshot
+{
+    struct axis
+    {
+        double zero;
+        int src;
+        bool invert, altp;
+    };
+
+    axis axes[6];
+
+    int neck_z;
+    bool neck_enable;
+
+    bool tcomp_p;
+    bool tcomp_disable_tx, tcomp_disable_ty, tcomp_disable_tz;
+    bool tcomp_disable_src_yaw, tcomp_disable_src_pitch, tcomp_disable_src_roll;
+
+    bool center_at_startup;
+
+    bool predict_enable, predict_auto;
+    int predict_model, predict_ms, predict_max_rot, predict_max_pos;
+};
+
+// what the pipeline computed on its last tick
+struct pose_snapshot
+{
+    Pose raw, corrected, filtered, mapped;
+    long long time = 0; // Timer::now_nsecs()
+};
+
 class OTR_LOGIC_EXPORT pipeline : private QThread, private bits
 {
     Q_OBJECT
@@ -58,13 +95,18 @@ private:
     using rmat = euler::rmat;
     using euler_t = euler::euler_t;
 
-    QMutex mtx;
     main_settings s;
     Mappings& m;
+
+    settings_snapshot cs;
+    std::atomic<bool> settings_dirty { true };
     event_handler& ev;
 
     Timer t;
+    // only touched by the pipeline thread
     Pose output_pose, raw_6dof, last_mapped, last_raw;
+    // readers never block the pipeline thread
+    seqlock<pose_snapshot> published;
 
     Pose newpose;
     runtime_libraries const& libs;
@@ -87,13 +129,28 @@ private:
 
     ns backlog_time = ns(0);
 
+    latency_stats latency;
+    long long last_sample_time = 0;
+
+    // one thread per protocol
+    std::vector<std::unique_ptr<protocol_output>> outputs;
+
+    pose_predictor predictor;
+    Timer predict_lead_timer;
+    double measured_lead = 0;
+
     bool tracking_started = false;
 
-    double map(double pos, Map& axis);
+    double map(double pos, unsigned i);
+    void update_settings();
     void logic();
     void t_compensate(const rmat& rmat, const euler_t& ypr, euler_t& output,
                       bool disable_tx, bool disable_ty, bool disable_tz);
     void run() override;
+    void run_adaptive();
+    void run_fixed_rate(int hz);
+    void log_header();
+    void finish();
 
     static constexpr double r2d = 180. / M_PI;
     static constexpr double d2r = M_PI / 180.;
@@ -106,8 +163,20 @@ public:
     ~pipeline();
 
     void raw_and_mapped_pose(double* mapped, double* raw) const;
+    pose_snapshot snapshot() const;
+    latency_stats& latency_statistics() { return latency; }
+    std::vector<latency_stats::named_summary> output_latency() const;
+    QString latency_report() const;
+    bool dump_latency(const QString& filename) const;
     void start() { QThread::start(QThread::HighPriority); }
 
+    // for headless replay. the caller drives iterations on its own
+    // thread instead of start(). never mix the two. without `header',
+    // the log continues the previous run's table.
+    void offline_begin(bool header = true);
+    void offline_step() { logic(); }
+    void offline_end();
+
     void center();
     void set_toggle(bool value);
     void set_zero(bool value);
@@ -118,3 +187,4 @@ public:
 } // ns impl
 
 using gui_tracker_impl::pipeline;
+using gui_tracker_impl::pose_snapshot;
@@ -0,0 +1,128 @@
+#include "pose-predictor.hpp"
+#include "compat/util.hpp"
+
+#include <cmath>
+
+constexpr long long pose_predictor::window_ns;
+constexpr unsigned pose_predictor::max_rate_hz;
+constexpr unsigned pose_predictor::history_size;
+
+void pose_predictor::add(const Pose& pose, long long time)
+{
+    if (count > 0 && history[(head + history_size - 1) % history_size].time >= time)
+        return;
+
+    history[head] = { pose, time };
+    head = (head + 1) % history_size;
+    if (count < history_size)
+        count++;
+}
+
+void pose_predictor::reset()
+{
+    head = 0;
+    count = 0;
+}
+
+static inline double wrap_180(double x)
+{
+    if (x > 180)
+        return x - 360;
+    if (x < -180)
+        return x + 360;
+    return x;
+}
+
+Pose pose_predictor::predict(const Pose& pose, long long time, const params& p) const
+{
+    Pose ret = pose;
+
+    const unsigned min_samples = p.kind == constant_acceleration ? 3 : 2;
+
+    if (p.lead <= 0 || count < min_samples)
+        return ret;
+
+    // least squares over history within the window, with time in seconds
+    // relative to `time' and values relative to the current pose.
+    // u^0..u^4 moments are shared by all axes.
+    double su[5] {};
+    double sy[6] {}, suy[6] {}, su2y[6] {};
+    unsigned n = 0;
+
+    for (unsigned k = 0; k < count; k++)
+    {
+        const entry& e = history[(head + history_size - 1 - k) % history_size];
+
+        if (time - e.time > window_ns)
+            break;
+
+        const double u = (e.time - time) * 1e-9;
+        const double u2 = u * u;
+
+        su[0] += 1; su[1] += u; su[2] += u2; su[3] += u2 * u; su[4] += u2 * u2;
+
+        for (unsigned i = 0; i < 6; i++)
+        {
+            double y = e.pose(i) - pose(i);
+            if (i >= 3)
+                y = wrap_180(y);
+
+            sy[i] += y;
+            suy[i] += u * y;
+            su2y[i] += u2 * y;
+        }
+
+        n++;
+    }
+
+    if (n < min_samples)
+        return ret;
+
+    const double L = p.lead;
+
+    for (unsigned i = 0; i < 6; i++)
+    {
+        double delta;
+
+        if (p.kind == constant_acceleration)
+        {
+            // normal equations for y = a + b u + c u^2, by cramer's rule
+            const double m00 = su[0], m01 = su[1], m02 = su[2];
+            const double m11 = su[2], m12 = su[3], m22 = su[4];
+
+            const double det = m00 * (m11 * m22 - m12 * m12)
+                             - m01 * (m01 * m22 - m12 * m02)
+                             + m02 * (m01 * m12 - m11 * m02);
+
+            if (std::fabs(det) < 1e-30)
+                return ret;
+
+            const double b = (m00 * (suy[i] * m22 - m12 * su2y[i])
+                            - sy[i] * (m01 * m22 - m12 * m02)
+                            + m02 * (m01 * su2y[i] - suy[i] * m02)) / det;
+            const double c = (m00 * (m11 * su2y[i] - suy[i] * m12)
+                            - m01 * (m01 * su2y[i] - suy[i] * m02)
+                            + sy[i] * (m01 * m12 - m11 * m02)) / det;
+
+            delta = b * L + c * L * L;
+        }
+        else
+        {
+            const double den = su[0] * su[2] - su[1] * su[1];
+
+            if (std::fabs(den) < 1e-30)
+                return ret;
+
+            const double b = (su[0] * suy[i] - su[1] * sy[i]) / den;
+
+            delta = b * L;
+        }
+
+        const double max = i >= 3 ? p.max_rot : p.max_pos;
+        ret(i) += clamp(delta, -max, max);
+        if (i >= 3)
+            ret(i) = wrap_180(ret(i));
+    }
+
+    return ret;
+}
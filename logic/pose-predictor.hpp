@@ -0,0 +1,52 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "api/plugin-api.hpp"
+#include "export.hpp"
+
+// extrapolates the filtered pose forward in time to hide tracker and
+// filter latency. fits a line or a parabola to the last few dozen ms of
+// history, then adds its change over the lead time to the current pose.
+class OTR_LOGIC_EXPORT pose_predictor final
+{
+public:
+    enum model
+    {
+        constant_velocity = 0,
+        constant_acceleration = 1,
+    };
+
+    struct params
+    {
+        model kind;
+        double lead;            // seconds
+        double max_rot, max_pos; // largest correction per axis, degrees and cm
+    };
+
+    // `time' is in Timer::now_nsecs() units
+    void add(const Pose& pose, long long time);
+    Pose predict(const Pose& pose, long long time, const params& p) const;
+    void reset();
+
+private:
+    static constexpr long long window_ns = 50 * 1000 * 1000;
+    // enough for the whole window at the fastest pipeline rate,
+    // main_settings::rate_1000
+    static constexpr unsigned max_rate_hz = 1000;
+    static constexpr unsigned history_size = unsigned(window_ns * max_rate_hz / 1000000000) + 1;
+
+    struct entry
+    {
+        Pose pose;
+        long long time;
+    };
+
+    entry history[history_size];
+    unsigned head = 0, count = 0;
+};
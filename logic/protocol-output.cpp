@@ -0,0 +1,82 @@
+#include "protocol-output.hpp"
+#include "compat/timer.hpp"
+
+#include <chrono>
+
+protocol_output::protocol_output(const std::shared_ptr<IProtocol>& proto, const QString& name) :
+    proto(proto),
+    name_(name),
+    thread([this] { run(); })
+{
+}
+
+protocol_output::~protocol_output()
+{
+    stop();
+}
+
+void protocol_output::pose(const double* value, long long time)
+{
+    slot s;
+    for (unsigned i = 0; i < 6; i++)
+        s.pose[i] = value[i];
+    s.time = time;
+
+    latest.store(s);
+    seq.fetch_add(1);
+
+    // pairs with the store in run(). both sides are seq_cst, so either
+    // the output thread sees the new `seq' or we see it's going to sleep.
+    if (sleeping.load())
+    {
+        std::lock_guard<std::mutex> l(mtx);
+        cvar.notify_one();
+    }
+}
+
+void protocol_output::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> l(mtx);
+        quit.store(true);
+    }
+    cvar.notify_one();
+
+    thread.join();
+}
+
+void protocol_output::run()
+{
+    unsigned last = seq.load();
+
+    for (;;)
+    {
+        const unsigned cur = seq.load();
+
+        if (cur == last)
+        {
+            if (quit.load())
+                break;
+
+            std::unique_lock<std::mutex> l(mtx);
+            sleeping.store(true);
+            cvar.wait_for(l, std::chrono::milliseconds(100),
+                          [&] { return quit.load() || seq.load() != last; });
+            sleeping.store(false);
+            continue;
+        }
+
+        if (cur - last > 1)
+            superseded.fetch_add(cur - last - 1, std::memory_order_relaxed);
+        last = cur;
+
+        const slot s = latest.load();
+
+        proto->pose(s.pose);
+
+        send_latency.add(Timer::now_nsecs() - s.time);
+    }
+}
@@ -0,0 +1,68 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "api/plugin-api.hpp"
+#include "compat/seqlock.hpp"
+#include "latency-stats.hpp"
+#include "export.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <QString>
+
+// runs one protocol's pose() on a thread of its own, so that a protocol
+// blocking on i/o can't hold up the pipeline or the other protocols.
+// only the newest pose matters; ones not yet sent get replaced.
+class OTR_LOGIC_EXPORT protocol_output final
+{
+    struct slot
+    {
+        double pose[6];
+        long long time;
+    };
+
+    std::shared_ptr<IProtocol> proto;
+    QString name_;
+
+    seqlock<slot> latest;
+    std::atomic<unsigned> seq { 0 };
+    std::atomic<bool> sleeping { false }, quit { false };
+
+    std::mutex mtx;
+    std::condition_variable cvar;
+
+    latency_impl::histogram send_latency;
+    std::atomic<unsigned> superseded { 0 };
+
+    // last, so that it starts after everything else is constructed
+    std::thread thread;
+
+    void run();
+
+public:
+    protocol_output(const std::shared_ptr<IProtocol>& proto, const QString& name);
+    ~protocol_output();
+
+    protocol_output(const protocol_output&) = delete;
+    protocol_output& operator=(const protocol_output&) = delete;
+
+    // pipeline thread only. never blocks on the protocol.
+    void pose(const double* value, long long time);
+    // delivers the last pose, then joins
+    void stop();
+
+    const QString& name() const { return name_; }
+    // time from pose() until the protocol returned, in ms
+    latency_impl::histogram::summary get_latency() const { return send_latency.get(); }
+    unsigned get_superseded() const { return superseded.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,193 @@
+#include "replay.hpp"
+#include "compat/timer.hpp"
+
+#include <chrono>
+#include <cmath>
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QDebug>
+
+using namespace replay_impl;
+
+void replay_tracker::data(double* data)
+{
+    for (int i = 0; i < 6; i++)
+        data[i] = cur(i);
+}
+
+QString replay_protocol::game_name()
+{
+    return QStringLiteral("replay");
+}
+
+bool pipeline_replay::load_csv(const QString& filename, std::vector<sample>& samples, QString& error)
+{
+    static constexpr const char* raw_names[6] =
+    {
+        "rawTX", "rawTY", "rawTZ", "rawYaw", "rawPitch", "rawRoll",
+    };
+
+    QFile f(filename);
+
+    if (!f.open(QFile::ReadOnly | QFile::Text))
+    {
+        error = f.errorString();
+        return false;
+    }
+
+    QTextStream in(&f);
+
+    const QStringList header = in.readLine().split(',');
+
+    int raw_cols[6];
+    const int dt_col = header.indexOf(QStringLiteral("dt"));
+
+    for (unsigned i = 0; i < 6; i++)
+    {
+        raw_cols[i] = header.indexOf(QLatin1String(raw_names[i]));
+        if (raw_cols[i] == -1)
+        {
+            error = QStringLiteral("missing column %1").arg(raw_names[i]);
+            return false;
+        }
+    }
+
+    samples.clear();
+
+    unsigned bad_lines = 0;
+
+    while (!in.atEnd())
+    {
+        const QStringList cols = in.readLine().split(',');
+
+        if (cols.size() != header.size())
+        {
+            bad_lines++;
+            continue;
+        }
+
+        sample s;
+        bool ok = true;
+
+        for (unsigned i = 0; i < 6 && ok; i++)
+            s.raw(i) = cols[raw_cols[i]].toDouble(&ok);
+
+        s.dt = dt_col != -1 && ok ? cols[dt_col].toDouble(&ok) : 4e-3;
+
+        if (!ok)
+        {
+            bad_lines++;
+            continue;
+        }
+
+        samples.push_back(s);
+    }
+
+    if (bad_lines)
+        qDebug() << "replay:" << bad_lines << "malformed lines skipped";
+
+    if (samples.empty())
+    {
+        error = QStringLiteral("no samples");
+        return false;
+    }
+
+    return true;
+}
+
+pipeline_replay::pipeline_replay(Mappings& m, const std::shared_ptr<dylib>& filter,
+                                 const Modules::dylib_list& extensions, TrackLogger& logger) :
+    m(m),
+    logger(logger),
+    ev(extensions),
+    filter(filter),
+    tracker(std::make_shared<replay_tracker>())
+{
+    Timer::set_virtual_clock(now);
+
+    libs.pTracker = tracker;
+    libs.pProtocol = std::make_shared<replay_protocol>();
+
+    if (!make_filter())
+        return;
+
+    libs.correct = true;
+    ok = true;
+}
+
+bool pipeline_replay::make_filter()
+{
+    libs.pFilter = nullptr;
+
+    if (!filter)
+        return true;
+
+    libs.pFilter = make_dylib_instance<IFilter>(filter);
+
+    if (!libs.pFilter)
+        return false;
+
+    const module_status status = libs.pFilter->initialize();
+    if (!status.is_ok())
+    {
+        qDebug() << "replay: filter" << filter->name << "failed:" << status.error;
+        libs.pFilter = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+pipeline_replay::~pipeline_replay()
+{
+    libs = runtime_libraries();
+    Timer::use_system_clock();
+}
+
+pipeline_replay::result pipeline_replay::run(const std::vector<sample>& samples)
+{
+    using clock = std::chrono::steady_clock;
+
+    result ret {};
+
+    if (!ok)
+        return ret;
+
+    // the constructor's filter is still unused on the first run
+    if (runs > 0 && !make_filter())
+        return ret;
+
+    pipeline p(m, libs, ev, logger);
+
+    const long long start = now;
+    const clock::time_point wall_start = clock::now();
+
+    // one table in the output, however many runs
+    p.offline_begin(runs++ == 0);
+
+    for (const sample& s : samples)
+    {
+        // outliers like the first row's dt mustn't stall the filters
+        const double dt = std::fmin(std::fmax(0., s.dt), 1.);
+        now += (long long) std::round(dt * 1e9);
+        Timer::set_virtual_clock(now);
+
+        tracker->cur = s.raw;
+        tracker->notify_new_sample(now);
+
+        p.offline_step();
+    }
+
+    p.offline_end();
+
+    const clock::duration wall = clock::now() - wall_start;
+
+    ret.ticks = unsigned(samples.size());
+    ret.wall_seconds = std::chrono::duration<double>(wall).count();
+    ret.virtual_seconds = (now - start) * 1e-9;
+    ret.ns_per_tick = ret.ticks ? std::chrono::duration<double, std::nano>(wall).count() / ret.ticks : 0;
+
+    return ret;
+}
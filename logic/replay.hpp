@@ -0,0 +1,93 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "api/plugin-support.hpp"
+#include "pipeline.hpp"
+#include "mappings.hpp"
+#include "extensions.hpp"
+#include "runtime-libraries.hpp"
+#include "tracklogger.hpp"
+
+#include "export.hpp"
+
+#include <vector>
+#include <memory>
+
+#include <QString>
+
+namespace replay_impl {
+
+// feeds recorded raw poses into the pipeline
+struct replay_tracker final : ITracker
+{
+    Pose cur;
+
+    module_status start_tracker(QFrame*) override { return status_ok(); }
+    void data(double* data) override;
+};
+
+// swallows the output, the logger gets to see it anyway
+struct replay_protocol final : IProtocol
+{
+    module_status initialize() override { return status_ok(); }
+    void pose(const double*) override {}
+    QString game_name() override;
+};
+
+} // ns replay_impl
+
+// runs recorded head motion through the same pipeline::logic() path as
+// live tracking. centering, filter, mapping curves, tcomp and neck all
+// come from the current profile. time is virtual, so it runs as fast as
+// the cpu allows while the filter still sees the recorded frame timing.
+class OTR_LOGIC_EXPORT pipeline_replay final
+{
+public:
+    struct sample
+    {
+        double dt; // seconds since the previous sample
+        Pose raw;
+    };
+
+    struct result
+    {
+        unsigned ticks;
+        double wall_seconds, virtual_seconds;
+        double ns_per_tick;
+    };
+
+    // reads the "dt" and "raw*" columns of a TrackLogger csv file
+    static bool load_csv(const QString& filename, std::vector<sample>& samples, QString& error);
+
+    // the virtual clock is in effect from here until destruction,
+    // so that the filter's own timers get to use it too
+    pipeline_replay(Mappings& m, const std::shared_ptr<dylib>& filter,
+                    const Modules::dylib_list& extensions, TrackLogger& logger);
+    ~pipeline_replay();
+
+    bool is_ok() const { return ok; }
+    // each run starts with a fresh filter, like a new tracking session
+    result run(const std::vector<sample>& samples);
+
+    pipeline_replay(const pipeline_replay&) = delete;
+    pipeline_replay& operator=(const pipeline_replay&) = delete;
+
+private:
+    bool make_filter();
+
+    Mappings& m;
+    TrackLogger& logger;
+    event_handler ev;
+    runtime_libraries libs;
+    std::shared_ptr<dylib> filter;
+    std::shared_ptr<replay_impl::replay_tracker> tracker;
+    long long now = 0;
+    unsigned runs = 0;
+    bool ok = false;
+};
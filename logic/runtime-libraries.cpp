@@ -3,7 +3,8 @@
 #include <QMessageBox>
 #include <QDebug>
 
-runtime_libraries::runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f)
+runtime_libraries::runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f,
+                                     const std::vector<dylibptr>& extra_protos)
 {
     module_status status =
             module_status_mixin::error(otr_tr("Library load failure"));
@@ -24,6 +25,33 @@ runtime_libraries::runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dyli
         goto end;
     }
 
+    protocol_name = p->name;
+
+    // a broken secondary output shouldn't prevent tracking
+    for (const dylibptr& lib : extra_protos)
+    {
+        if (!lib || lib->name == p->name)
+            continue;
+
+        std::shared_ptr<IProtocol> proto = make_dylib_instance<IProtocol>(lib);
+
+        if (!proto)
+        {
+            qDebug() << "protocol dylib load failure" << lib->name;
+            continue;
+        }
+
+        const module_status extra_status = proto->initialize();
+
+        if (!extra_status.is_ok())
+        {
+            qDebug() << "protocol" << lib->name << "failed:" << extra_status.error;
+            continue;
+        }
+
+        pExtraProtocols.push_back({ lib->name, std::move(proto) });
+    }
+
     pTracker = make_dylib_instance<ITracker>(t);
     pFilter = make_dylib_instance<IFilter>(f);
 
@@ -55,6 +83,7 @@ end:
     pTracker = nullptr;
     pFilter = nullptr;
     pProtocol = nullptr;
+    pExtraProtocols.clear();
 
     if (!status.is_ok())
         QMessageBox::critical(nullptr, "Startup failure", status.error, QMessageBox::Cancel, QMessageBox::NoButton);
@@ -11,7 +11,10 @@
 #include "api/plugin-support.hpp"
 #include "export.hpp"
 
+#include <vector>
+
 #include <QFrame>
+#include <QString>
 
 struct OTR_LOGIC_EXPORT runtime_libraries final
 {
@@ -20,8 +23,19 @@ struct OTR_LOGIC_EXPORT runtime_libraries final
     std::shared_ptr<ITracker> pTracker;
     std::shared_ptr<IFilter> pFilter;
     std::shared_ptr<IProtocol> pProtocol;
+    QString protocol_name;
+
+    struct extra_protocol
+    {
+        QString name;
+        std::shared_ptr<IProtocol> proto;
+    };
+
+    // these get the same output as pProtocol
+    std::vector<extra_protocol> pExtraProtocols;
 
-    runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f);
+    runtime_libraries(QFrame* frame, dylibptr t, dylibptr p, dylibptr f,
+                      const std::vector<dylibptr>& extra_protos = std::vector<dylibptr>());
     runtime_libraries() : pTracker(nullptr), pFilter(nullptr), pProtocol(nullptr), correct(false) {}
 
     bool correct = false;
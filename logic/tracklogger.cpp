@@ -1,6 +1,9 @@
 #include "tracklogger.hpp"
 #include "pipeline.hpp"
 
+#include <chrono>
+#include <algorithm>
+
 TrackLogger::~TrackLogger() {}
 
 void TrackLogger::reset_dt()
@@ -41,7 +44,110 @@ void TrackLoggerCSV::write(const double *p, int n)
 
 void TrackLoggerCSV::next_line()
 {
-    out << std::endl;
+    out.put('\n');
     first_col = true;
 }
 
+
+constexpr unsigned TrackLoggerAsync::max_columns;
+constexpr unsigned TrackLoggerAsync::queue_size;
+
+TrackLoggerAsync::TrackLoggerAsync(const QString& filename) : queue(queue_size)
+{
+    out.open(filename.toStdString());
+
+    if (out.is_open())
+        writer = std::thread([this] { run_writer(); });
+}
+
+TrackLoggerAsync::~TrackLoggerAsync()
+{
+    if (writer.joinable())
+    {
+        {
+            std::unique_lock<std::mutex> l(writer_mtx);
+            quit = true;
+        }
+        writer_cvar.notify_one();
+        writer.join();
+    }
+
+    if (dropped_rows())
+        qDebug() << "tracklogger: dropped" << dropped_rows() << "rows";
+}
+
+void TrackLoggerAsync::write(const char *s)
+{
+    std::unique_lock<std::mutex> l(out_mtx);
+
+    if (header_line)
+        out.put(',');
+    header_line = true;
+    out << s;
+}
+
+void TrackLoggerAsync::write(const double *p, int n)
+{
+    if (unsigned(n) > max_columns - cur.ncols)
+    {
+        cur_overflow = true;
+        return;
+    }
+
+    std::copy(p, p + n, cur.values + cur.ncols);
+    cur.ncols += unsigned(n);
+}
+
+void TrackLoggerAsync::next_line()
+{
+    if (header_line)
+    {
+        std::unique_lock<std::mutex> l(out_mtx);
+        out.put('\n');
+        header_line = false;
+    }
+
+    if (cur_overflow || (cur.ncols > 0 && !queue.push(cur)))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+
+    cur.ncols = 0;
+    cur_overflow = false;
+}
+
+void TrackLoggerAsync::write_row(const row& r)
+{
+    for (unsigned i = 0; i < r.ncols; i++)
+    {
+        if (i)
+            out.put(',');
+        out << r.values[i];
+    }
+    out.put('\n');
+}
+
+void TrackLoggerAsync::run_writer()
+{
+    for (;;)
+    {
+        bool quit_;
+
+        {
+            std::unique_lock<std::mutex> l(writer_mtx);
+            writer_cvar.wait_for(l, std::chrono::milliseconds(100), [this] { return quit; });
+            quit_ = quit;
+        }
+
+        {
+            std::unique_lock<std::mutex> l(out_mtx);
+
+            row r;
+            while (queue.pop(r))
+                write_row(r);
+
+            out.flush();
+        }
+
+        if (quit_)
+            break;
+    }
+}
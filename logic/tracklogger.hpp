@@ -3,7 +3,14 @@
 #include "options/options.hpp"
 #include "compat/timer.hpp"
 
+#include "compat/spsc-queue.hpp"
+
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include <QString>
 #include <QMessageBox>
 #include <QWidget>
@@ -63,3 +70,49 @@ public:
     void next_line() override;
 };
 
+// the pipeline thread only copies each row into a preallocated queue.
+// a writer thread formats and writes them out as csv in batches, so that
+// disk stalls never delay pose output. rows are dropped, not waited for,
+// if the writer can't keep up. so are rows wider than max_columns, rather
+// than written truncated.
+class OTR_LOGIC_EXPORT TrackLoggerAsync : public TrackLogger
+{
+public:
+    static constexpr unsigned max_columns = 32;
+    static constexpr unsigned queue_size = 4096;
+
+private:
+    struct row final
+    {
+        unsigned ncols;
+        double values[max_columns];
+    };
+
+    std::ofstream out;
+    spsc_queue<row> queue;
+    row cur {};
+    bool header_line = false, cur_overflow = false;
+    std::atomic<unsigned> dropped { 0 };
+
+    // header columns are written from the pipeline thread before any rows
+    std::mutex out_mtx;
+
+    std::mutex writer_mtx;
+    std::condition_variable writer_cvar;
+    bool quit = false;
+    std::thread writer;
+
+    void run_writer();
+    void write_row(const row& r);
+
+public:
+    TrackLoggerAsync(const QString& filename);
+    ~TrackLoggerAsync() override;
+
+    bool is_open() const { return out.is_open(); }
+    unsigned dropped_rows() const { return dropped.load(std::memory_order_relaxed); }
+
+    void write(const char *s) override;
+    void write(const double *p, int n) override;
+    void next_line() override;
+};
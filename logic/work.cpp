@@ -29,7 +29,7 @@ QString Work::browse_datalogging_file(main_settings &s)
     return newfilename;
 }
 
-std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s)
+std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s, QString& log_filename)
 {
     if (s.tracklogging_enabled)
     {
@@ -40,7 +40,7 @@ std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s)
         }
         else
         {
-            auto logger = std::make_shared<TrackLoggerCSV>(s.tracklogging_filename);
+            auto logger = std::make_shared<TrackLoggerAsync>(s.tracklogging_filename);
             if (!logger->is_open())
             {
                 logger = nullptr;
@@ -51,6 +51,7 @@ std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s)
             }
             else
             {
+                log_filename = s.tracklogging_filename;
                 return logger;
             }
         }
@@ -59,9 +60,10 @@ std::shared_ptr<TrackLogger> Work::make_logger(main_settings &s)
 }
 
 
-Work::Work(Mappings& m, event_handler& ev,  QFrame* frame, std::shared_ptr<dylib> tracker_, std::shared_ptr<dylib> filter_, std::shared_ptr<dylib> proto_) :
-    libs(frame, tracker_, filter_, proto_),
-    logger(make_logger(s)),
+Work::Work(Mappings& m, event_handler& ev,  QFrame* frame, std::shared_ptr<dylib> tracker_, std::shared_ptr<dylib> filter_, std::shared_ptr<dylib> proto_,
+           const std::vector<std::shared_ptr<dylib>>& extra_protos) :
+    libs(frame, tracker_, filter_, proto_, extra_protos),
+    logger(make_logger(s, log_filename)),
     tracker(std::make_shared<pipeline>(m, libs, ev, *logger)),
     sc(std::make_shared<Shortcuts>()),
     keys {
@@ -99,6 +101,10 @@ bool Work::is_ok() const
 
 Work::~Work()
 {
+    // next to the log this session actually wrote, if any
+    if (tracker && !log_filename.isEmpty())
+        (void) tracker->dump_latency(log_filename + QStringLiteral(".latency.csv"));
+
     // order matters, otherwise use-after-free -sh
     sc = nullptr;
     tracker = nullptr;
@@ -29,18 +29,20 @@ struct OTR_LOGIC_EXPORT Work
     using fn_t = std::function<void(bool)>;
     using key_tuple = std::tuple<key_opts&, fn_t, bool>;
     main_settings s; // tracker needs settings, so settings must come before it
+    QString log_filename; // empty unless a log file got opened, before logger
     runtime_libraries libs; // idem
     std::shared_ptr<TrackLogger> logger; // must come before tracker, since tracker depends on it
     std::shared_ptr<pipeline> tracker;
     std::shared_ptr<Shortcuts> sc;
     std::vector<key_tuple> keys;
 
-    Work(Mappings& m, event_handler& ev, QFrame* frame, std::shared_ptr<dylib> tracker, std::shared_ptr<dylib> filter, std::shared_ptr<dylib> proto);
+    Work(Mappings& m, event_handler& ev, QFrame* frame, std::shared_ptr<dylib> tracker, std::shared_ptr<dylib> filter, std::shared_ptr<dylib> proto,
+         const std::vector<std::shared_ptr<dylib>>& extra_protos = std::vector<std::shared_ptr<dylib>>());
     ~Work();
     void reload_shortcuts();
     bool is_ok() const;
 
 private:
-    static std::shared_ptr<TrackLogger> make_logger(main_settings &s);
+    static std::shared_ptr<TrackLogger> make_logger(main_settings &s, QString& log_filename);
     static QString browse_datalogging_file(main_settings &s);
 };
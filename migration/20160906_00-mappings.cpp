@@ -36,30 +36,26 @@ struct mappings_from_2_3_0_rc11 : migration
             "rz", "rz_alt",
         };
 
-        return group::with_settings_object([&](QSettings& settings) {
-            for (const char* name : names)
-            {
-                QList<QPointF> points;
-
-                settings.beginGroup(QString("Curves-%1").arg(name));
-
-                const int max = settings.value("point-count", 0).toInt();
+        for (const char* name : names)
+        {
+            QList<QPointF> points;
 
-                for (int i = 0; i < max; i++)
-                {
-                    QPointF new_point(settings.value(QString("point-%1-x").arg(i), 0).toDouble(),
-                                      settings.value(QString("point-%1-y").arg(i), 0).toDouble());
+            const group g(QString("Curves-%1").arg(name));
 
-                    points.append(new_point);
-                }
+            const int max = g.get<int>("point-count");
 
-                settings.endGroup();
+            for (int i = 0; i < max; i++)
+            {
+                QPointF new_point(g.get<double>(QString("point-%1-x").arg(i)),
+                                  g.get<double>(QString("point-%1-y").arg(i)));
 
-                ret.append(points);
+                points.append(new_point);
             }
 
-            return ret;
-        });
+            ret.append(points);
+        }
+
+        return ret;
     }
 
     QString unique_date() const override { return "20160909_00"; }
@@ -61,6 +61,8 @@ struct axis_signs_split_rc11 : migration
         bundle new_bundle = make_bundle("opentrack-mappings");
         bundle old_bundle = make_bundle("opentrack-ui");
 
+        transaction t(new_bundle);
+
         for (const char* name : axis_names)
             new_bundle->store_kv(fmt.arg(name), QVariant(old_bundle->get<bool>(fmt.arg(name))));
 
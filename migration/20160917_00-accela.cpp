@@ -87,6 +87,8 @@ struct move_accela_to_sliders : migration
         bundle old_b = make_bundle(old_bundle_name);
         bundle new_b = make_bundle(new_bundle_name);
 
+        transaction t(new_b);
+
         for (unsigned i = 0; settings[i].old_name; i++)
         {
             const map& cur = settings[i];
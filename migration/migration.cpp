@@ -14,7 +14,6 @@
 #include "compat/util.hpp"
 
 #include <QString>
-#include <QSettings>
 #include <QChar>
 
 #include <QDebug>
@@ -76,15 +75,12 @@ std::vector<migration*>& migrator::migrations()
 
 QString migrator::last_migration_time()
 {
-    QString ret;
+    const options::group g("migrations");
 
-    options::group::with_settings_object([&](QSettings& s) {
-        s.beginGroup("migrations");
-        ret = s.value("last-migration-at", "19700101_00").toString();
-        s.endGroup();
-    });
+    if (!g.contains("last-migration-at"))
+        return QStringLiteral("19700101_00");
 
-    return ret;
+    return g.get<QString>("last-migration-at");
 }
 
 QString migrator::time_after_migrations()
@@ -102,16 +98,13 @@ QString migrator::time_after_migrations()
 
 void migrator::set_last_migration_time(const QString& val)
 {
-    options::group::with_settings_object([&](QSettings& s) {
-        s.beginGroup("migrations");
-        const QString old_value = s.value("last-migration-at", "").toString();
-        if (val != old_value)
-        {
-            s.setValue("last-migration-at", val);
-            options::group::mark_ini_modified();
-        }
-        s.endGroup();
-    });
+    options::group g("migrations");
+
+    if (val != g.get<QString>("last-migration-at"))
+    {
+        g.put("last-migration-at", val);
+        g.save();
+    }
 }
 
 std::vector<migration*> migrator::sorted_migrations()
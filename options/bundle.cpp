@@ -9,6 +9,8 @@
 #include "bundle.hpp"
 #include "value.hpp"
 
+#include <utility>
+
 #include <QThread>
 #include <QApplication>
 
@@ -43,8 +45,14 @@ void bundle::reload()
         if (has_changes)
         {
             connector::notify_all_values();
-            emit reloading();
-            emit changed();
+
+            if (transaction_depth > 0)
+                pending_reloading = true, pending_changed = true;
+            else
+            {
+                emit reloading();
+                emit changed();
+            }
         }
     }
 }
@@ -53,10 +61,14 @@ void bundle::set_all_to_default()
 {
     QMutexLocker l(&mtx);
 
+    begin_transaction();
+
     forall([](const QString&, base_value* val) { set_base_value_to_default(val); });
 
     if (is_modified())
         group::mark_ini_modified();
+
+    commit_transaction();
 }
 
 void bundle::store_kv(const QString& name, const QVariant& datum)
@@ -65,10 +77,49 @@ void bundle::store_kv(const QString& name, const QVariant& datum)
 
     transient.put(name, datum);
 
+    // values still get notified right away, so reading them back
+    // inside a transaction gives what was just stored
     if (group_name.size())
         connector::notify_values(name);
 
-    emit changed();
+    if (transaction_depth > 0)
+        pending_changed = true;
+    else
+        emit changed();
+}
+
+void bundle::begin_transaction()
+{
+    QMutexLocker l(&mtx);
+    transaction_depth++;
+}
+
+void bundle::commit_transaction()
+{
+    bool changed_, reloading_, save_;
+
+    {
+        QMutexLocker l(&mtx);
+
+        if (transaction_depth == 0)
+        {
+            qDebug() << "bundle" << group_name << "commit without a transaction";
+            return;
+        }
+
+        if (--transaction_depth > 0)
+            return;
+
+        changed_ = pending_changed, reloading_ = pending_reloading, save_ = pending_save;
+        pending_changed = false, pending_reloading = false, pending_save = false;
+    }
+
+    if (reloading_)
+        emit reloading();
+    if (changed_)
+        emit changed();
+    if (save_)
+        save();
 }
 
 bool bundle::contains(const QString &name) const
@@ -90,6 +141,12 @@ void bundle::save()
     {
         QMutexLocker l(&mtx);
 
+        if (transaction_depth > 0)
+        {
+            pending_save = true;
+            return;
+        }
+
         if (is_modified())
         {
             //qDebug() << "bundle" << group_name << "changed, saving";
@@ -135,16 +192,29 @@ void bundler::after_profile_changed_()
 {
     QMutexLocker l(&implsgl_mtx);
 
+    std::vector<shared> bundles;
+    bundles.reserve(implsgl_data.size());
+
     for (auto& kv : implsgl_data)
     {
         weak bundle = kv.second;
         shared bundle_ = bundle.lock();
         if (bundle_)
-        {
-            //qDebug() << "bundle: reverting" << kv.first << "due to profile change";
-            bundle_->reload();
-        }
+            bundles.push_back(std::move(bundle_));
     }
+
+    // so that nothing listening sees a mix of the old and the new profile
+    for (shared& b : bundles)
+        b->begin_transaction();
+
+    for (shared& b : bundles)
+    {
+        //qDebug() << "bundle: reverting" << b->name() << "due to profile change";
+        b->reload();
+    }
+
+    for (shared& b : bundles)
+        b->commit_transaction();
 }
 
 void bundler::refresh_all_bundles()
@@ -200,6 +270,16 @@ QMutex* bundle::get_mtx() const { return mtx; }
 
 } // end options::detail
 
+transaction::transaction(bundle b) : b(std::move(b))
+{
+    this->b->begin_transaction();
+}
+
+transaction::~transaction()
+{
+    b->commit_transaction();
+}
+
 OTR_OPTIONS_EXPORT std::shared_ptr<bundle_> make_bundle(const QString& name)
 {
     if (name.size())
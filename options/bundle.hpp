@@ -53,6 +53,9 @@ private:
     group saved;
     group transient;
 
+    unsigned transaction_depth = 0;
+    bool pending_changed = false, pending_reloading = false, pending_save = false;
+
     bundle(const bundle&) = delete;
     bundle(bundle&&) = delete;
     bundle& operator=(bundle&&) = delete;
@@ -71,6 +74,12 @@ public:
     never_inline bool contains(const QString& name) const;
     never_inline bool is_modified() const;
 
+    // inside a transaction, stores and reloads don't emit changed() or
+    // reloading() and save() does nothing. the outermost commit emits
+    // each signal once and saves once, if anything asked for it.
+    void begin_transaction();
+    void commit_transaction();
+
     template<typename t>
     t get(const QString& name) const
     {
@@ -109,6 +118,18 @@ OTR_OPTIONS_EXPORT bundler& singleton();
 using bundle_ = detail::bundle;
 using bundle = std::shared_ptr<bundle_>;
 
+class OTR_OPTIONS_EXPORT transaction final
+{
+    bundle b;
+
+public:
+    explicit transaction(bundle b);
+    ~transaction();
+
+    transaction(const transaction&) = delete;
+    transaction& operator=(const transaction&) = delete;
+};
+
 OTR_OPTIONS_EXPORT std::shared_ptr<bundle_> make_bundle(const QString& name);
 
 } // ns options
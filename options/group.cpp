@@ -8,11 +8,14 @@
 
 #include "group.hpp"
 #include "defs.hpp"
+#include "ini-writer.hpp"
+#include "profile-cache.hpp"
 
 #include "compat/timer.hpp"
 #include "opentrack-library-path.h"
 
 #include <cmath>
+#include <utility>
 
 #include <QFile>
 #include <QStandardPaths>
@@ -21,23 +24,30 @@
 
 namespace options {
 
+// parses the whole .ini. every other group comes from memory after this.
+static void read_profile(const QString& path)
+{
+    const QSettings conf(path, QSettings::IniFormat);
+    detail::profile_cache::instance().fill(path, conf);
+}
+
 group::group(const QString& name) : name(name)
 {
     if (name == "")
         return;
 
-    with_settings_object([&](QSettings& conf) {
-        conf.beginGroup(name);
-        for (auto& k_ : conf.childKeys())
-        {
-            auto tmp = k_.toUtf8();
-            QString k(tmp);
-            QVariant val = conf.value(k_);
-            if (val.type() != QVariant::Invalid)
-                kvs[k] = std::move(val);
-        }
-        conf.endGroup();
-    });
+    using detail::profile_cache;
+
+    const QString path = ini_pathname();
+
+    if (path.isEmpty())
+        return;
+
+    if (profile_cache::instance().get(path, name, kvs))
+        return;
+
+    read_profile(path);
+    (void) profile_cache::instance().get(path, name, kvs);
 }
 
 void group::save() const
@@ -45,14 +55,20 @@ void group::save() const
     if (name == "")
         return;
 
-    with_settings_object([&](QSettings& s) {
-        s.beginGroup(name);
-        for (auto& i : kvs)
-            s.setValue(i.first, i.second);
-        s.endGroup();
+    using detail::profile_cache;
 
-        mark_ini_modified();
-    });
+    const QString path = ini_pathname();
+
+    if (path.isEmpty())
+        return;
+
+    // only the groups that were saved would get written otherwise
+    profile_cache::group_kvs tmp;
+    if (!profile_cache::instance().get(path, name, tmp))
+        read_profile(path);
+
+    profile_cache::instance().put(path, name, kvs);
+    detail::ini_writer::instance().schedule(path);
 }
 
 void group::put(const QString &s, const QVariant &d)
@@ -142,16 +158,30 @@ QStringList group::ini_list()
 
 void group::mark_ini_modified()
 {
-    QMutexLocker l(&cur_ini_mtx);
-    ini_modifiedp = true;
+    const QString path = ini_pathname();
+
+    if (!path.isEmpty())
+        detail::ini_writer::instance().schedule(path);
+}
+
+void group::flush()
+{
+    detail::ini_writer::instance().flush();
+}
+
+// qsettings posts itself an event to sync on the thread it lives on.
+// the ini writer does that instead, off the gui thread. profiles don't
+// need it, their QSettings objects are never changed.
+static std::shared_ptr<QSettings> make_settings_object(std::shared_ptr<QSettings> s)
+{
+    s->moveToThread(nullptr);
+    return s;
 }
 
 QString group::cur_ini_pathname;
 
 std::shared_ptr<QSettings> group::cur_ini;
 QMutex group::cur_ini_mtx(QMutex::Recursive);
-int group::ini_refcount = 0;
-bool group::ini_modifiedp = false;
 
 std::shared_ptr<QSettings> group::cur_global_ini;
 QMutex group::global_ini_mtx(QMutex::Recursive);
@@ -180,11 +210,11 @@ std::shared_ptr<QSettings> group::cur_global_settings_object()
         return cur_global_ini;
 
     if (!is_portable_installation())
-        cur_global_ini = std::make_shared<QSettings>(OPENTRACK_ORG);
+        cur_global_ini = make_settings_object(std::make_shared<QSettings>(OPENTRACK_ORG));
     else
     {
         static const QString pathname = OPENTRACK_BASE_PATH + QStringLiteral("/globals.ini");
-        cur_global_ini = std::make_shared<QSettings>(pathname, QSettings::IniFormat);
+        cur_global_ini = make_settings_object(std::make_shared<QSettings>(pathname, QSettings::IniFormat));
     }
 
     return cur_global_ini;
@@ -196,15 +226,13 @@ group::saver_::~saver_()
     if (--refcount == 0 && modifiedp)
     {
         modifiedp = false;
-        s.sync();
-        if (s.status() != QSettings::NoError)
-            qDebug() << "error with .ini file" << s.fileName() << s.status();
+        detail::ini_writer::instance().schedule(s, mtx);
     }
 }
 
 never_inline
-group::saver_::saver_(QSettings& s, int& refcount, bool& modifiedp) :
-    s(s), refcount(refcount), modifiedp(modifiedp)
+group::saver_::saver_(std::shared_ptr<QSettings> s, QMutex& mtx, int& refcount, bool& modifiedp) :
+    s(std::move(s)), mtx(mtx), refcount(refcount), modifiedp(modifiedp)
 {
     refcount++;
 }
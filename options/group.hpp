@@ -25,8 +25,6 @@ class OTR_OPTIONS_EXPORT group final
     static QString cur_ini_pathname;
 
     static std::shared_ptr<QSettings> cur_ini;
-    static int ini_refcount;
-    static bool ini_modifiedp;
     static QMutex cur_ini_mtx;
 
     static std::shared_ptr<QSettings> cur_global_ini;
@@ -34,14 +32,16 @@ class OTR_OPTIONS_EXPORT group final
     static bool global_ini_modifiedp;
     static QMutex global_ini_mtx;
 
+    // once the outermost user is done, has the ini writer sync the object
     struct OTR_OPTIONS_EXPORT saver_ final
     {
-        QSettings& s;
+        std::shared_ptr<QSettings> s;
+        QMutex& mtx;
         int& refcount;
         bool& modifiedp;
 
         never_inline ~saver_();
-        never_inline saver_(QSettings& s, int& refcount, bool& modifiedp);
+        never_inline saver_(std::shared_ptr<QSettings> s, QMutex& mtx, int& refcount, bool& modifiedp);
     };
     static std::shared_ptr<QSettings> cur_settings_object();
     static std::shared_ptr<QSettings> cur_global_settings_object();
@@ -59,7 +59,10 @@ public:
     static QStringList ini_list();
     static bool is_portable_installation();
 
+    // has the ini writer write the current profile out
     static void mark_ini_modified();
+    // blocks until pending changes are on disk
+    static void flush();
 
     template<typename t>
     never_inline
@@ -71,24 +74,26 @@ public:
         return t();
     }
 
+    // the .ini as it was read, for looking at only. changes go through
+    // group::save(), otherwise they'd be left pending in the object.
     template<typename F>
     never_inline
     static auto with_settings_object(F&& fun)
     {
         QMutexLocker l(&cur_ini_mtx);
-        saver_ saver { *cur_settings_object(), ini_refcount, ini_modifiedp };
+        const std::shared_ptr<const QSettings> s = cur_settings_object();
 
-        return fun(saver.s);
+        return fun(*s);
     }
 
     template<typename F>
     static auto with_global_settings_object(F&& fun)
     {
         QMutexLocker l(&global_ini_mtx);
-        saver_ saver { *cur_global_settings_object(), global_ini_refcount, global_ini_modifiedp };
+        saver_ saver { cur_global_settings_object(), global_ini_mtx, global_ini_refcount, global_ini_modifiedp };
         global_ini_modifiedp = true;
 
-        return fun(saver.s);
+        return fun(*saver.s);
     }
 };
 
@@ -0,0 +1,235 @@
+#include "ini-writer.hpp"
+#include "profile-cache.hpp"
+
+#include <utility>
+#include <algorithm>
+#include <cstdio>
+
+#include <QFile>
+#include <QVariant>
+#include <QDebug>
+
+#ifdef _WIN32
+#   include <windows.h>
+#endif
+
+namespace options {
+namespace detail {
+
+constexpr int ini_writer::debounce_ms;
+constexpr int ini_writer::max_delay_ms;
+
+ini_writer::ini_writer() : thread([this] { run(); })
+{
+}
+
+ini_writer::~ini_writer()
+{
+    flush();
+
+    {
+        std::lock_guard<std::mutex> l(mtx);
+        quit = true;
+    }
+    cvar.notify_one();
+    thread.join();
+}
+
+ini_writer& ini_writer::instance()
+{
+    static ini_writer ret;
+    return ret;
+}
+
+void ini_writer::schedule(const QString& path)
+{
+    job j;
+    j.path = path;
+    add(path, std::move(j));
+}
+
+void ini_writer::schedule(const std::shared_ptr<QSettings>& settings, QMutex& settings_mtx)
+{
+    job j;
+    j.settings = settings;
+    j.mtx = &settings_mtx;
+    add(settings->fileName(), std::move(j));
+}
+
+void ini_writer::add(const QString& key, job&& j)
+{
+    const clock::time_point now = clock::now();
+
+    {
+        std::lock_guard<std::mutex> l(mtx);
+
+        auto it = jobs.find(key);
+
+        if (it == jobs.end())
+        {
+            j.first = now;
+            j.due = now + std::chrono::milliseconds(debounce_ms);
+            jobs[key] = std::move(j);
+        }
+        else
+        {
+            job& old = it->second;
+            // the global QSettings object got replaced meanwhile
+            old.settings = std::move(j.settings);
+            old.mtx = j.mtx;
+            old.due = std::min(now + std::chrono::milliseconds(debounce_ms),
+                               old.first + std::chrono::milliseconds(max_delay_ms));
+        }
+    }
+
+    cvar.notify_one();
+}
+
+void ini_writer::post(std::function<void()> fun)
+{
+    {
+        std::lock_guard<std::mutex> l(mtx);
+        tasks.push_back(std::move(fun));
+    }
+
+    cvar.notify_one();
+}
+
+void ini_writer::flush()
+{
+    std::unique_lock<std::mutex> l(mtx);
+
+    flushing = true;
+    cvar.notify_one();
+    done_cvar.wait(l, [this] { return jobs.empty() && tasks.empty() && busy == 0; });
+    flushing = false;
+}
+
+void ini_writer::run()
+{
+    std::unique_lock<std::mutex> l(mtx);
+
+    for (;;)
+    {
+        if (!tasks.empty())
+        {
+            const std::function<void()> fun = std::move(tasks.front());
+            tasks.pop_front();
+
+            busy++;
+            l.unlock();
+
+            fun();
+
+            l.lock();
+            busy--;
+            continue;
+        }
+
+        if (jobs.empty())
+        {
+            if (quit)
+                break;
+
+            done_cvar.notify_all();
+            cvar.wait(l);
+            continue;
+        }
+
+        auto it = jobs.begin();
+        for (auto it2 = jobs.begin(); it2 != jobs.end(); it2++)
+            if (it2->second.due < it->second.due)
+                it = it2;
+
+        if (!flushing && it->second.due > clock::now())
+        {
+            cvar.wait_until(l, it->second.due);
+            continue;
+        }
+
+        const job j = std::move(it->second);
+        jobs.erase(it);
+
+        busy++;
+        l.unlock();
+
+        write(j);
+
+        l.lock();
+        busy--;
+    }
+}
+
+void ini_writer::write(const job& j)
+{
+    if (!j.settings)
+    {
+        write_profile(j.path);
+        return;
+    }
+
+    // small, and seldom written. leaves the object with nothing pending,
+    // unlike copying it out would.
+    QMutexLocker l(j.mtx);
+    j.settings->sync();
+    if (j.settings->status() != QSettings::NoError)
+        qDebug() << "error with settings" << j.settings->fileName() << j.settings->status();
+}
+
+void ini_writer::write_profile(const QString& path)
+{
+    unsigned gen = 0;
+    const std::shared_ptr<const profile_cache::contents> data = profile_cache::instance().snapshot(path, gen);
+
+    // written already
+    if (!data)
+        return;
+
+    const QString tmp = path + QStringLiteral(".tmp");
+
+    (void) QFile::remove(tmp);
+
+    {
+        QSettings out(tmp, QSettings::IniFormat);
+
+        for (const auto& group : *data)
+        {
+            const QString prefix = group.first.isEmpty() ? QString() : group.first + '/';
+
+            for (const auto& kv : group.second)
+                out.setValue(prefix + kv.first, kv.second);
+        }
+
+        out.sync();
+
+        if (out.status() != QSettings::NoError)
+        {
+            qDebug() << "error with .ini file" << tmp << out.status();
+            (void) QFile::remove(tmp);
+            return;
+        }
+    }
+
+    if (!replace_file(tmp, path))
+    {
+        qDebug() << "can't replace .ini file" << path;
+        (void) QFile::remove(tmp);
+        return;
+    }
+
+    profile_cache::instance().stored(path, data, gen);
+}
+
+bool ini_writer::replace_file(const QString& from, const QString& to)
+{
+#ifdef _WIN32
+    return MoveFileExW(reinterpret_cast<const wchar_t*>(from.utf16()),
+                       reinterpret_cast<const wchar_t*>(to.utf16()),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0;
+#endif
+}
+
+} // ns options::detail
+} // ns options
@@ -0,0 +1,83 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "export.hpp"
+
+#include <memory>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <functional>
+
+#include <QString>
+#include <QSettings>
+#include <QMutex>
+
+namespace options {
+namespace detail {
+
+// writes .ini files on a thread of its own, some time after the last
+// change, so that saving settings never waits on the disk.
+class OTR_OPTIONS_EXPORT ini_writer final
+{
+    using clock = std::chrono::steady_clock;
+
+    struct job
+    {
+        // a profile, written out from profile_cache
+        QString path;
+        // or a settings object that's only synced. only the global one.
+        std::shared_ptr<QSettings> settings;
+        // guards `settings'
+        QMutex* mtx = nullptr;
+        clock::time_point first, due;
+    };
+
+    // wait this long for more changes to the same file
+    static constexpr int debounce_ms = 250;
+    // but don't keep putting it off past this
+    static constexpr int max_delay_ms = 2000;
+
+    std::mutex mtx;
+    std::condition_variable cvar, done_cvar;
+    std::map<QString, job> jobs;
+    std::deque<std::function<void()>> tasks;
+    unsigned busy = 0;
+    bool flushing = false, quit = false;
+
+    // last, so that it starts after everything else is constructed
+    std::thread thread;
+
+    ini_writer();
+    void run();
+    void add(const QString& key, job&& j);
+    static void write(const job& j);
+    static void write_profile(const QString& path);
+    static bool replace_file(const QString& from, const QString& to);
+
+public:
+    ~ini_writer();
+
+    static ini_writer& instance();
+
+    // writes the profile at `path' out of profile_cache some time later
+    void schedule(const QString& path);
+    // calls sync() on `settings' some time later, with `mtx' held
+    void schedule(const std::shared_ptr<QSettings>& settings, QMutex& mtx);
+    // runs `fun' on the writer thread, ahead of any pending file
+    void post(std::function<void()> fun);
+    // writes everything pending now and waits for it
+    void flush();
+};
+
+} // ns options::detail
+} // ns options
@@ -0,0 +1,127 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+// times reading value<t> through its cache against the locked bundle
+// path it replaced, and checks that both agree after stores.
+//
+// opentrack-options-bench [reads]
+
+#include "options/options.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+
+#include <QCoreApplication>
+#include <QString>
+#include <QVariant>
+
+using namespace options;
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+template<typename F>
+double ns_per_read(unsigned reads, F&& read)
+{
+    const clock::time_point start = clock::now();
+
+    for (unsigned i = 0; i < reads; i++)
+        read();
+
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() / reads;
+}
+
+// the same values in a named bundle, which are cached, and in an unnamed
+// one, which never notifies its values and so reads through the bundle
+// like every value used to
+template<typename t>
+struct bench_values final
+{
+    const char* type_name;
+    bundle cached_b, uncached_b;
+    value<t> cached, uncached;
+    t other;
+
+    bench_values(const char* type_name, bundle cached_b, bundle uncached_b, t def, t other) :
+        type_name(type_name),
+        cached_b(cached_b), uncached_b(uncached_b),
+        cached(cached_b, type_name, def), uncached(uncached_b, type_name, def),
+        other(other)
+    {
+    }
+
+    bool check()
+    {
+        bool ok = cached() == uncached();
+
+        // through the bundle, as the options dialog and reload() do
+        cached_b->store_kv(type_name, QVariant::fromValue(other));
+        uncached_b->store_kv(type_name, QVariant::fromValue(other));
+        ok &= cached() == other && uncached() == other;
+
+        cached = cached.default_value();
+        uncached = uncached.default_value();
+        ok &= cached() == cached.default_value() && uncached() == uncached.default_value();
+
+        if (!ok)
+            std::printf("value<%s>: cached and uncached reads disagree\n", type_name);
+
+        return ok;
+    }
+
+    void time(unsigned reads)
+    {
+        volatile t sink = t();
+        const QString name(type_name);
+
+        const double cached_ns = ns_per_read(reads, [&] { sink = cached(); });
+        const double uncached_ns = ns_per_read(reads, [&] { sink = uncached(); });
+        const double variant_ns = ns_per_read(reads, [&] {
+            sink = cached_b->get<QVariant>(name).template value<t>();
+        });
+
+        std::printf("value<%s>: cached %.1f ns, uncached %.1f ns, bundle::get<QVariant> %.1f ns, %.1fx\n",
+                    type_name, cached_ns, uncached_ns, variant_ns,
+                    cached_ns > 0 ? uncached_ns / cached_ns : 0.);
+    }
+};
+
+} // ns
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const unsigned reads = argc > 1 ? std::max(1u, unsigned(std::strtoul(argv[1], nullptr, 10))) : 10000000u;
+
+    // nothing gets saved, so the profile stays as it is
+    bundle cached_b = make_bundle("options-bench"), uncached_b = make_bundle(QString());
+
+    bench_values<int> i("int", cached_b, uncached_b, 42, 7);
+    bench_values<double> d("double", cached_b, uncached_b, .5, 2.25);
+    bench_values<bool> b("bool", cached_b, uncached_b, true, false);
+
+    bool ok = true;
+    ok &= i.check();
+    ok &= d.check();
+    ok &= b.check();
+
+    i.time(reads);
+    d.time(reads);
+    b.time(reads);
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "cached values disagree with the bundle\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,260 @@
+#include "profile-cache.hpp"
+#include "ini-writer.hpp"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QByteArray>
+#include <QStringList>
+#include <QDebug>
+
+namespace options {
+namespace detail {
+
+static constexpr quint32 cache_magic = 0x6f747263; // "otrc"
+static constexpr quint32 cache_version = 1;
+
+profile_cache& profile_cache::instance()
+{
+    static profile_cache ret;
+    return ret;
+}
+
+QString profile_cache::cache_pathname(const QString& path)
+{
+    return path + QStringLiteral(".cache");
+}
+
+bool profile_cache::get(const QString& path, const QString& group, group_kvs& ret)
+{
+    std::shared_ptr<const contents> data;
+
+    {
+        std::lock_guard<std::mutex> l(mtx);
+
+        entry& e = entries[path];
+
+        // the .ini might've been copied over or removed since
+        if (e.gen == e.stored_gen)
+        {
+            const stamp ini_stamp = stat(path);
+
+            if (!e.data || !(e.ini_stamp == ini_stamp))
+            {
+                e.data = load(path, ini_stamp);
+                e.ini_stamp = ini_stamp;
+            }
+        }
+
+        data = e.data;
+    }
+
+    if (!data)
+        return false;
+
+    const auto it = data->find(group);
+    if (it != data->cend())
+        ret = it->second;
+    else
+        ret.clear();
+
+    return true;
+}
+
+void profile_cache::fill(const QString& path, const QSettings& s)
+{
+    // before the parse, so a change during it makes the entry stale
+    const stamp ini_stamp = stat(path);
+
+    auto data = std::make_shared<contents>();
+
+    for (const QString& k : s.allKeys())
+    {
+        QVariant value = s.value(k);
+
+        if (value.type() == QVariant::Invalid)
+            continue;
+
+        // same as QSettings::beginGroup() followed by childKeys()
+        const int idx = k.lastIndexOf('/');
+
+        if (idx < 0)
+            (*data)[QString()][k] = std::move(value);
+        else
+            (*data)[k.left(idx)][k.mid(idx + 1)] = std::move(value);
+    }
+
+    {
+        std::lock_guard<std::mutex> l(mtx);
+        entry& e = entries[path];
+        // what's in memory is newer
+        if (e.data && e.gen != e.stored_gen)
+            return;
+        e.data = data;
+        e.ini_stamp = ini_stamp;
+    }
+
+    ini_writer::instance().post([path, data] { (void) save(path, *data); });
+}
+
+void profile_cache::put(const QString& path, const QString& group, const group_kvs& kvs)
+{
+    std::lock_guard<std::mutex> l(mtx);
+
+    entry& e = entries[path];
+
+    // copied, the writer may be reading the old one
+    auto data = e.data ? std::make_shared<contents>(*e.data) : std::make_shared<contents>();
+    group_kvs& dest = (*data)[group];
+
+    for (const auto& kv : kvs)
+        dest[kv.first] = kv.second;
+
+    e.data = std::move(data);
+    e.gen++;
+}
+
+std::shared_ptr<const profile_cache::contents> profile_cache::snapshot(const QString& path, unsigned& gen)
+{
+    std::lock_guard<std::mutex> l(mtx);
+
+    const auto it = entries.find(path);
+
+    if (it == entries.cend() || it->second.gen == it->second.stored_gen)
+        return nullptr;
+
+    gen = it->second.gen;
+    return it->second.data;
+}
+
+void profile_cache::stored(const QString& path, const std::shared_ptr<const contents>& data, unsigned gen)
+{
+    // nothing else writes the .ini, so the file matches it from here on
+    const stamp ini_stamp = save(path, *data);
+
+    std::lock_guard<std::mutex> l(mtx);
+
+    entry& e = entries[path];
+
+    if (gen > e.stored_gen)
+        e.stored_gen = gen;
+    // writes happen in order, this is the newest
+    e.ini_stamp = ini_stamp;
+}
+
+profile_cache::stamp profile_cache::stat(const QString& path)
+{
+    const QFileInfo ini(path);
+    stamp ret;
+
+    if (ini.exists())
+    {
+        ret.mtime = ini.lastModified().toMSecsSinceEpoch();
+        ret.size = ini.size();
+    }
+
+    return ret;
+}
+
+std::shared_ptr<const profile_cache::contents> profile_cache::load(const QString& path, const stamp& ini_stamp)
+{
+    if (ini_stamp.size < 0)
+        return nullptr;
+
+    QFile f(cache_pathname(path));
+
+    if (!f.open(QFile::ReadOnly))
+        return nullptr;
+
+    const qint64 size = f.size();
+    const uchar* const ptr = f.map(0, size);
+
+    if (!ptr)
+        return nullptr;
+
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(ptr), int(size));
+    QDataStream ds(raw);
+    ds.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0, version = 0;
+    qint64 mtime = 0, ini_size = 0;
+    ds >> magic >> version >> mtime >> ini_size;
+
+    if (ds.status() != QDataStream::Ok || magic != cache_magic || version != cache_version)
+        return nullptr;
+
+    if (mtime != ini_stamp.mtime || ini_size != ini_stamp.size)
+        return nullptr;
+
+    auto ret = std::make_shared<contents>();
+
+    quint32 ngroups = 0;
+    ds >> ngroups;
+
+    for (quint32 i = 0; i < ngroups && ds.status() == QDataStream::Ok; i++)
+    {
+        QString group;
+        quint32 nkeys = 0;
+        ds >> group >> nkeys;
+
+        group_kvs& kvs = (*ret)[group];
+
+        for (quint32 k = 0; k < nkeys && ds.status() == QDataStream::Ok; k++)
+        {
+            QString key;
+            QVariant value;
+            ds >> key >> value;
+            kvs[key] = std::move(value);
+        }
+    }
+
+    if (ds.status() != QDataStream::Ok)
+    {
+        qDebug() << "profile cache: can't read" << f.fileName();
+        return nullptr;
+    }
+
+    return ret;
+}
+
+profile_cache::stamp profile_cache::save(const QString& path, const contents& data)
+{
+    const stamp ini_stamp = stat(path);
+
+    if (ini_stamp.size < 0)
+        return ini_stamp;
+
+    QSaveFile f(cache_pathname(path));
+
+    if (!f.open(QFile::WriteOnly))
+        return ini_stamp;
+
+    QDataStream ds(&f);
+    ds.setVersion(QDataStream::Qt_5_0);
+
+    ds << cache_magic << cache_version << ini_stamp.mtime << ini_stamp.size;
+
+    ds << quint32(data.size());
+
+    for (const auto& group : data)
+    {
+        ds << group.first << quint32(group.second.size());
+        for (const auto& kv : group.second)
+            ds << kv.first << kv.second;
+    }
+
+    if (ds.status() != QDataStream::Ok)
+    {
+        qDebug() << "profile cache: can't write" << f.fileName();
+        f.cancelWriting();
+    }
+
+    (void) f.commit();
+
+    return ini_stamp;
+}
+
+} // ns options::detail
+} // ns options
@@ -0,0 +1,79 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "export.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <QString>
+#include <QVariant>
+#include <QSettings>
+
+namespace options {
+namespace detail {
+
+// every group of an .ini, kept in memory and in a binary file next to it.
+// once a profile is read, this is what group reads from and saves to;
+// the ini writer writes the .ini out from here. when nothing's pending,
+// an entry is only used while the .ini's mtime and size are the same as
+// when it was read or written, and so is the binary file.
+class OTR_OPTIONS_EXPORT profile_cache final
+{
+public:
+    using group_kvs = std::map<QString, QVariant>;
+    using contents = std::map<QString, group_kvs>;
+
+    static profile_cache& instance();
+
+    // false if `path' isn't in memory and has no current file
+    bool get(const QString& path, const QString& group, group_kvs& ret);
+    // from a QSettings that just parsed `path'
+    void fill(const QString& path, const QSettings& s);
+    // merges `kvs' into `group', like QSettings::setValue() would
+    void put(const QString& path, const QString& group, const group_kvs& kvs);
+
+    // the ini writer's thread. what to write, and its generation
+    std::shared_ptr<const contents> snapshot(const QString& path, unsigned& gen);
+    // after replacing `path' with `data' taken at generation `gen'
+    void stored(const QString& path, const std::shared_ptr<const contents>& data, unsigned gen);
+
+private:
+    struct stamp
+    {
+        qint64 mtime = -1, size = -1;
+        bool operator==(const stamp& x) const { return mtime == x.mtime && size == x.size; }
+    };
+
+    struct entry
+    {
+        std::shared_ptr<const contents> data;
+        // bumped by put()
+        unsigned gen = 0;
+        // what the .ini has
+        unsigned stored_gen = 0;
+        // the .ini's, when `data' last matched it
+        stamp ini_stamp;
+    };
+
+    std::mutex mtx;
+    std::map<QString, entry> entries;
+
+    static QString cache_pathname(const QString& path);
+    // of `path', or an invalid one if it doesn't exist
+    static stamp stat(const QString& path);
+    static std::shared_ptr<const contents> load(const QString& path, const stamp& ini_stamp);
+    static stamp save(const QString& path, const contents& data);
+
+    profile_cache() = default;
+};
+
+} // ns options::detail
+} // ns options
@@ -11,6 +11,7 @@
 #include "export.hpp"
 
 #include "compat/util.hpp"
+#include "compat/value-templates.hpp"
 
 #include "bundle.hpp"
 #include "slider.hpp"
@@ -18,6 +19,7 @@
 #include "value-traits.hpp"
 
 #include <cstdio>
+#include <atomic>
 #include <type_traits>
 #include <typeinfo>
 #include <typeindex>
@@ -31,19 +33,55 @@
 
 namespace options {
 
+namespace detail {
+
+// copy of the current value for reading without the bundle lock. only
+// for types small enough for a lock-free atomic. refreshed under the
+// bundle lock whenever the bundle notifies values of a change.
+template<typename t, typename Enable = void>
+struct value_cache final
+{
+    static constexpr bool enabled = false;
+
+    void store(const t&) {}
+    t load() const { return t(); }
+};
+
+template<typename t>
+struct value_cache<t, std::enable_if_t<is_trivially_copyable_v<t> && sizeof(t) <= sizeof(long long)>> final
+{
+    static constexpr bool enabled = true;
+
+    std::atomic<t> x;
+
+    void store(const t& val) { x.store(val, std::memory_order_release); }
+    t load() const { return x.load(std::memory_order_acquire); }
+};
+
+} // ns detail
+
 template<typename t>
 class value final : public base_value
 {
     using traits = detail::value_traits<t, t, void>;
     using element_type = typename traits::element_type;
+    using cache_type = detail::value_cache<t>;
 
     static bool is_equal(const QVariant& val1, const QVariant& val2)
     {
         return val1.value<element_type>() == val2.value<element_type>();
     }
 
-    never_inline
     t get() const
+    {
+        if (cache_type::enabled && use_cache)
+            return cache.load();
+
+        return get_uncached();
+    }
+
+    never_inline
+    t get_uncached() const
     {
         if (self_name.isEmpty())
             return def;
@@ -81,6 +119,13 @@ public:
             QObject::connect(b.get(), SIGNAL(reloading()),
                              this, SLOT(reload()),
                              DIRECT_CONNTYPE);
+
+        // bundles without a name never notify their values
+        if (cache_type::enabled && !self_name.isEmpty() && !b->name().isEmpty())
+        {
+            cache.store(get_uncached());
+            use_cache = true;
+        }
     }
 
     template<unsigned k>
@@ -121,7 +166,12 @@ public:
     void bundle_value_changed() const override
     {
         if (!self_name.isEmpty())
+        {
+            if (use_cache)
+                cache.store(get_uncached());
+
             emit valueChanged(traits::to_storage(get()));
+        }
     }
 
     never_inline
@@ -138,6 +188,8 @@ public:
     }
 
 private:
+    mutable cache_type cache;
+    bool use_cache = false;
     const t def;
 };
 
@@ -0,0 +1,113 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+// replays a tracking log through the current profile's pipeline,
+// headless and faster than real time.
+//
+// opentrack-replay [--filter name] [--output out.csv] [--repeat n] input.csv
+
+#include "logic/replay.hpp"
+#include "logic/main-settings.hpp"
+#include "logic/mappings.hpp"
+#include "logic/tracklogger.hpp"
+#include "api/plugin-support.hpp"
+#include "opentrack-library-path.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStringList>
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("opentrack-replay");
+
+    QCommandLineParser args;
+    args.setApplicationDescription("replay a tracking log through the current profile");
+    args.addHelpOption();
+    args.addPositionalArgument("input", "csv file written by the tracking logger");
+
+    const QCommandLineOption filter_opt("filter", "filter module name, 'none' for no filter", "name");
+    const QCommandLineOption output_opt("output", "write the pipeline's output as csv", "file");
+    const QCommandLineOption repeat_opt("repeat", "run the input this many times", "n", "1");
+
+    args.addOptions({ filter_opt, output_opt, repeat_opt });
+    args.process(app);
+
+    const QStringList positional = args.positionalArguments();
+
+    if (positional.size() != 1)
+        args.showHelp(1);
+
+    std::vector<pipeline_replay::sample> samples;
+    QString error;
+
+    if (!pipeline_replay::load_csv(positional[0], samples, error))
+    {
+        std::fprintf(stderr, "can't load %s: %s\n",
+                     positional[0].toLocal8Bit().constData(),
+                     error.toLocal8Bit().constData());
+        return 1;
+    }
+
+    Modules modules(OPENTRACK_BASE_PATH + OPENTRACK_LIBRARY_PATH);
+    main_settings s;
+    module_settings ms;
+    Mappings m(s.all_axis_opts);
+
+    const QString filter_name = args.isSet(filter_opt)
+                                ? args.value(filter_opt)
+                                : ms.filter_dll;
+
+    std::shared_ptr<dylib> filter;
+
+    if (filter_name != "none" && !filter_name.isEmpty())
+    {
+        for (const std::shared_ptr<dylib>& lib : modules.filters())
+            if (lib->module_name == filter_name || lib->name == filter_name)
+                filter = lib;
+
+        if (!filter)
+        {
+            std::fprintf(stderr, "no filter named %s\n", filter_name.toLocal8Bit().constData());
+            return 1;
+        }
+    }
+
+    std::unique_ptr<TrackLogger> logger;
+
+    if (args.isSet(output_opt))
+        logger = std::make_unique<TrackLoggerCSV>(args.value(output_opt));
+    else
+        logger = std::make_unique<TrackLogger>();
+
+    const unsigned repeat = std::max(1u, args.value(repeat_opt).toUInt());
+
+    pipeline_replay replay(m, filter, modules.extensions(), *logger);
+
+    if (!replay.is_ok())
+    {
+        std::fprintf(stderr, "can't initialize filter %s\n", filter_name.toLocal8Bit().constData());
+        return 1;
+    }
+
+    for (unsigned i = 0; i < repeat; i++)
+    {
+        const pipeline_replay::result r = replay.run(samples);
+
+        std::printf("run %u: %u ticks, %.3f s recorded, %.3f s wall, %.0f ns/tick, %.1fx real time\n",
+                    i + 1, r.ticks, r.virtual_seconds, r.wall_seconds, r.ns_per_tick,
+                    r.wall_seconds > 0 ? r.virtual_seconds / r.wall_seconds : 0.);
+    }
+
+    return 0;
+}
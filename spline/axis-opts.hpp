@@ -33,6 +33,14 @@ struct OTR_SPLINE_EXPORT axis_opts final
         x1000 = 1000,
     };
 
+    enum curve_kind
+    {
+        // 4096 samples of the catmull-rom spline
+        curve_sampled = 0,
+        // monotone cubic hermite, evaluated from the points directly
+        curve_monotone = 1,
+    };
+
     // note, these two bundles can be the same value with no issues
     bundle b_settings_window = make_bundle("opentrack-ui");
     bundle b_mapping_window = make_bundle("opentrack-mappings");
@@ -40,6 +48,7 @@ struct OTR_SPLINE_EXPORT axis_opts final
     value<int> src;
     value<bool> invert, altp;
     value<max_clamp> clamp_x_, clamp_y_;
+    value<curve_kind> curve;
     double max_clamp_x() const { return std::fabs(clamp_x_.to<double>()); }
     double max_clamp_y() const { return std::fabs(clamp_y_.to<double>()); }
     axis_opts(QString pfx, Axis idx);
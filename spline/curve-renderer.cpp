@@ -0,0 +1,119 @@
+#include "curve-renderer.hpp"
+
+#include <utility>
+#include <algorithm>
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QPen>
+
+curve_renderer::curve_renderer() : thread([this] { run(); })
+{
+}
+
+curve_renderer::~curve_renderer()
+{
+    {
+        std::lock_guard<std::mutex> l(mtx);
+        quit = true;
+    }
+    cvar.notify_one();
+    thread.join();
+}
+
+curve_renderer& curve_renderer::instance()
+{
+    static curve_renderer ret;
+    return ret;
+}
+
+curve_renderer::client::client(callback done) : done(std::move(done))
+{
+    // start the thread now rather than from within a destructor
+    (void) instance();
+}
+
+curve_renderer::client::~client()
+{
+    curve_renderer& r = instance();
+
+    std::unique_lock<std::mutex> l(r.mtx);
+
+    if (pending)
+    {
+        r.queue.erase(std::find(r.queue.begin(), r.queue.end(), this));
+        pending = false;
+    }
+
+    r.idle_cvar.wait(l, [&] { return r.busy != this; });
+}
+
+void curve_renderer::client::render(job j)
+{
+    curve_renderer& r = instance();
+
+    {
+        std::lock_guard<std::mutex> l(r.mtx);
+
+        next = std::move(j);
+
+        if (!pending)
+        {
+            pending = true;
+            r.queue.push_back(this);
+        }
+    }
+
+    r.cvar.notify_one();
+}
+
+QImage curve_renderer::draw(const job& j)
+{
+    QImage ret(j.size, QImage::Format_ARGB32_Premultiplied);
+    ret.fill(Qt::transparent);
+
+    if (j.pixels.isEmpty())
+        return ret;
+
+    QPainter painter(&ret);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setClipRegion(j.clip);
+    painter.setPen(QPen(j.color, 1.75, Qt::SolidLine, Qt::FlatCap));
+
+    QPainterPath path;
+    path.moveTo(j.pixels[0]);
+
+    for (int i = 1; i + 2 < j.pixels.size(); i += 3)
+        path.cubicTo(j.pixels[i], j.pixels[i+1], j.pixels[i+2]);
+
+    painter.drawPath(path);
+
+    return ret;
+}
+
+void curve_renderer::run()
+{
+    std::unique_lock<std::mutex> l(mtx);
+
+    for (;;)
+    {
+        cvar.wait(l, [this] { return quit || !queue.empty(); });
+
+        if (quit)
+            break;
+
+        client& c = *queue.front();
+        queue.pop_front();
+
+        const job j = std::move(c.next);
+        c.pending = false;
+        busy = &c;
+
+        l.unlock();
+        c.done(draw(j), j.generation);
+        l.lock();
+
+        busy = nullptr;
+        idle_cvar.notify_all();
+    }
+}
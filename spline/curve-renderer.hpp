@@ -0,0 +1,84 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "export.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+
+#include <QImage>
+#include <QColor>
+#include <QSize>
+#include <QRegion>
+#include <QVector>
+#include <QPointF>
+
+// antialiases spline_widget curves into transparent images. one thread
+// shared by every widget, each with at most one job waiting. the curves are
+// already evaluated, so no spline access here.
+class OTR_SPLINE_EXPORT curve_renderer final
+{
+public:
+    struct job
+    {
+        QSize size;
+        QRegion clip;
+        QColor color;
+        // start point, then three per cubicTo()
+        QVector<QPointF> pixels;
+        unsigned generation = 0;
+    };
+
+    // called on the renderer's thread
+    using callback = std::function<void(const QImage&, unsigned generation)>;
+
+    // one per widget
+    class OTR_SPLINE_EXPORT client final
+    {
+        friend class curve_renderer;
+
+        callback done;
+        job next;
+        bool pending = false;
+
+    public:
+        explicit client(callback done);
+        // drops a waiting job and waits out one being drawn
+        ~client();
+
+        client(const client&) = delete;
+        client& operator=(const client&) = delete;
+
+        // replaces this client's job if it hasn't started yet
+        void render(job j);
+    };
+
+private:
+    curve_renderer();
+    ~curve_renderer();
+
+    static curve_renderer& instance();
+
+    void run();
+    static QImage draw(const job& j);
+
+    std::mutex mtx;
+    std::condition_variable cvar, idle_cvar;
+    // clients with a job, in the order they asked
+    std::deque<client*> queue;
+    // whose job is being drawn
+    const client* busy = nullptr;
+    bool quit = false;
+
+    // last, so that it starts after everything else is constructed
+    std::thread thread;
+};
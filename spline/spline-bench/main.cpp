@@ -0,0 +1,255 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+// checks the spline's fast paths against the plain ones they stand in
+// for, then times both: batched evaluation, and rebuilding only the part
+// of the table an edit touches.
+//
+// opentrack-spline-bench [repeat]
+
+#include "../spline.hpp"
+#include "api/plugin-api.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QList>
+#include <QPointF>
+
+using spline_detail::lut;
+
+struct spline_lut_bench final
+{
+    static std::shared_ptr<const lut> table(const spline& s)
+    {
+        return s.get_lut();
+    }
+
+    // so that the next edit rebuilds the whole table
+    static void forget_table(spline& s)
+    {
+        QMutexLocker l(&s._mutex);
+        std::atomic_store(&s.cur_lut, std::shared_ptr<const lut>());
+    }
+};
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+double ns_since(clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+}
+
+// nan compares unequal to itself, so bitwise
+bool same_floats(const float* a, const float* b, std::size_t n)
+{
+    return std::memcmp(a, b, n * sizeof(*a)) == 0;
+}
+
+// lut::get_values() against lut::get_value() one at a time, over the
+// whole input range, past both ends, and garbage like nan
+bool check_get_values(unsigned repeat)
+{
+    lut l;
+
+    // a curve up to 90 at 180, like a yaw mapping
+    const double last = lut::value_count - 1;
+    l.c = last / 180.;
+    for (unsigned k = 0; k < lut::value_count; k++)
+        l.data[k] = float(90 * k * k / (last * last));
+
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<double> in_range(-200, 200);
+
+    std::vector<double> xs(4099);
+    for (double& x : xs)
+        x = in_range(rng);
+
+    static const double garbage[] = {
+        std::numeric_limits<double>::quiet_NaN(),
+        -std::numeric_limits<double>::quiet_NaN(),
+        std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(),
+        3e9, -3e9, 1e300, -1e300, 0., -0.,
+    };
+
+    // every lane of a batch and the scalar tail
+    for (unsigned i = 0; i < sizeof(garbage)/sizeof(*garbage); i++)
+        for (unsigned k = 0; k < 5; k++)
+            xs[i * 37 + k] = garbage[i];
+    for (unsigned k = 1; k <= 3; k++)
+        xs[xs.size() - k] = garbage[k];
+
+    const std::size_t n = xs.size();
+    std::vector<float> batch(n), one_by_one(n);
+
+    l.get_values(xs.data(), batch.data(), n);
+    for (std::size_t i = 0; i < n; i++)
+        one_by_one[i] = l.get_value(xs[i]);
+
+    const bool ok = same_floats(batch.data(), one_by_one.data(), n);
+
+    if (!ok)
+        for (std::size_t i = 0; i < n; i++)
+            if (!same_floats(&batch[i], &one_by_one[i], 1))
+                std::printf("get_values(%g) = %g, get_value() = %g\n", xs[i], double(batch[i]), double(one_by_one[i]));
+
+    volatile float sink = 0;
+
+    clock::time_point start = clock::now();
+    for (unsigned r = 0; r < repeat; r++)
+        for (std::size_t i = 0; i < n; i++)
+            sink = sink + l.get_value(xs[i]);
+    const double scalar_ns = ns_since(start) / (double(repeat) * n);
+
+    start = clock::now();
+    for (unsigned r = 0; r < repeat; r++)
+    {
+        l.get_values(xs.data(), batch.data(), n);
+        sink = sink + batch[r % n];
+    }
+    const double batch_ns = ns_since(start) / (double(repeat) * n);
+
+    std::printf("get_values: %u inputs x %u, %s get_value(), %.2f ns each vs %.2f ns, %.2fx\n",
+                unsigned(n), repeat, ok ? "same as" : "DIFFERENT FROM",
+                batch_ns, scalar_ns, batch_ns > 0 ? scalar_ns / batch_ns : 0.);
+
+    return ok;
+}
+
+spline::settings& settings_of(spline& s)
+{
+    return static_cast<spline::settings&>(*s.get_settings());
+}
+
+enum edit_kind { edit_move, edit_insert, edit_remove, edit_kind_count };
+
+// spline::move_point(), add_point() and remove_point() with the table
+// rebuilt around the edit, against the same edits with the whole table
+// rebuilt. both tables have to come out the same.
+bool check_rebuild(unsigned edits)
+{
+    static const char* const names[edit_kind_count] = { "move", "insert", "remove" };
+
+    spline partial(QString(), "bench", Yaw), full(QString(), "bench", Yaw);
+
+    settings_of(partial).opts.curve = axis_opts::curve_sampled;
+
+    const double maxx = partial.max_input(), maxy = partial.max_output();
+
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    {
+        QList<QPointF> points;
+        for (int k = 1; k <= 16; k++)
+            points.push_back(QPointF(maxx * k / 17, maxy * unit(rng)));
+
+        settings_of(partial).points = points;
+        settings_of(full).points = points;
+    }
+
+    double partial_ns[edit_kind_count] {}, full_ns[edit_kind_count] {};
+    unsigned count[edit_kind_count] {}, mismatches = 0;
+
+    for (unsigned e = 0; e < edits; e++)
+    {
+        const edit_kind kind = edit_kind(e % edit_kind_count);
+        const QList<QPointF> points = partial.get_points();
+        const int n = partial.get_point_count();
+
+        if (n < 4 && kind == edit_remove)
+            continue;
+
+        const int idx = std::min(n - 1, int(unit(rng) * n));
+        const double y = maxy * unit(rng);
+        double x = maxx * unit(rng);
+
+        if (kind == edit_move)
+        {
+            // between the neighbors, points don't get reordered
+            const double lo = idx > 0 ? points[idx - 1].x() : 0;
+            const double hi = idx + 1 < n ? points[idx + 1].x() : maxx;
+            x = lo + (hi - lo) * (.1 + .8 * unit(rng));
+        }
+
+        const auto apply = [&](spline& s) {
+            switch (kind)
+            {
+            case edit_move: s.move_point(idx, QPointF(x, y)); break;
+            case edit_insert: s.add_point(x, y); break;
+            case edit_remove: s.remove_point(idx); break;
+            default: break;
+            }
+        };
+
+        clock::time_point start = clock::now();
+        apply(partial);
+        partial_ns[kind] += ns_since(start);
+
+        spline_lut_bench::forget_table(full);
+        start = clock::now();
+        apply(full);
+        full_ns[kind] += ns_since(start);
+
+        count[kind]++;
+
+        const std::shared_ptr<const lut> a = spline_lut_bench::table(partial);
+        const std::shared_ptr<const lut> b = spline_lut_bench::table(full);
+
+        if (a->c != b->c || a->data.size() != b->data.size() ||
+            !same_floats(a->data.data(), b->data.data(), a->data.size()))
+        {
+            if (mismatches++ < 10)
+                std::printf("rebuild: table differs after %s #%u\n", names[kind], e);
+        }
+    }
+
+    for (unsigned k = 0; k < edit_kind_count; k++)
+        std::printf("rebuild: %u %ss, %.0f ns each vs %.0f ns rebuilding the whole table, %.2fx\n",
+                    count[k], names[k],
+                    count[k] ? partial_ns[k] / count[k] : 0.,
+                    count[k] ? full_ns[k] / count[k] : 0.,
+                    partial_ns[k] > 0 ? full_ns[k] / partial_ns[k] : 0.);
+
+    std::printf("rebuild: %s\n", mismatches ? "tables DIFFER" : "tables are the same");
+
+    return mismatches == 0;
+}
+
+} // ns
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const unsigned repeat = argc > 1 ? std::max(1u, unsigned(std::strtoul(argv[1], nullptr, 10))) : 1000u;
+
+    bool ok = true;
+
+    ok &= check_get_values(repeat);
+    ok &= check_rebuild(repeat * 3);
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "fast paths disagree with the plain ones\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -36,6 +36,10 @@ spline_widget::spline_widget(QWidget *parent) :
     _draw_function(true),
     _preview_only(false)
 {
+    connect(this, &spline_widget::curve_rendered,
+            this, &spline_widget::set_curve,
+            Qt::QueuedConnection);
+
     setMouseTracking(true);
     setFocusPolicy(Qt::ClickFocus);
     setCursor(Qt::ArrowCursor);
@@ -76,6 +80,7 @@ QColor spline_widget::colorBezier() const
 void spline_widget::setColorBezier(QColor color)
 {
     spline_color = color;
+    _draw_function = true;
     repaint();
 }
 
@@ -158,59 +163,39 @@ void spline_widget::drawBackground()
     }
 }
 
-void spline_widget::drawFunction()
+QColor spline_widget::curve_color() const
 {
-    _function = _background;
-    QPainter painter(&_function);
-    painter.setRenderHint(QPainter::Antialiasing, true);
-
-    const points_t points = _config->get_points();
-
-    if (moving_control_point_idx >= 0 &&
-        moving_control_point_idx < points.size())
+    if (!isEnabled() && !_preview_only)
     {
-        const QPen pen(Qt::white, 1, Qt::SolidLine, Qt::FlatCap);
-        const QPointF prev_ = point_to_pixel(QPointF(0, 0));
-        QPoint prev(iround(prev_.x()), iround(prev_.y()));
-        for (int i = 0; i < points.size(); i++)
-        {
-            const QPointF tmp_ = point_to_pixel(points[i]);
-            const QPoint tmp(iround(tmp_.x()), iround(tmp_.y()));
-            drawLine(painter, prev, tmp, pen);
-            prev = tmp;
-        }
+        QColor color(spline_color);
+        const int avg = int(float(color.red() + color.green() + color.blue())/3);
+        return QColor(int(float(color.red() + avg)*.5f),
+                      int(float(color.green() + avg)*.5f),
+                      int(float(color.blue() + avg)*.5f),
+                      96);
     }
+    else
+    {
+        QColor color(spline_color);
+        color.setAlphaF(color.alphaF()*.9);
+        return color;
+    }
+}
 
-    const QColor color_ = progn(
-        if (!isEnabled() && !_preview_only)
-        {
-            QColor color(spline_color);
-            const int avg = int(float(color.red() + color.green() + color.blue())/3);
-            return QColor(int(float(color.red() + avg)*.5f),
-                          int(float(color.green() + avg)*.5f),
-                          int(float(color.blue() + avg)*.5f),
-                          96);
-        }
-        else
-        {
-            QColor color(spline_color);
-            color.setAlphaF(color.alphaF()*.9);
-            return color;
-        }
-    );
-
-    painter.setPen(QPen(color_, 1.75, Qt::SolidLine, Qt::FlatCap));
-
-//#define DEBUG_SPLINE
-#ifndef DEBUG_SPLINE
+void spline_widget::request_curve()
+{
     constexpr double step_ = 5;
 
     const double maxx = _config->max_input();
     const double step = step_ / c.x();
 
-    QPainterPath path;
+    std::vector<double> xs;
+    for (double k = 0; k < maxx; k += step*3)
+        for (unsigned i = 1; i <= 3; i++)
+            xs.push_back(k + step*i);
 
-    path.moveTo(point_to_pixel(QPointF(0, 0)));
+    std::vector<float> ys(xs.size());
+    _config->get_values(xs.data(), ys.data(), xs.size());
 
     const double max_x_pixel = point_to_pixel_(QPointF(maxx, 0)).x();
 
@@ -220,46 +205,63 @@ void spline_widget::drawFunction()
                : QPointF(max_x_pixel, val.y());
     };
 
-    for (double k = 0; k < maxx; k += step*3)
-    {
-        const float next_1(_config->get_value_no_save(k + step*1));
-        const float next_2(_config->get_value_no_save(k + step*2));
-        const float next_3(_config->get_value_no_save(k + step*3));
-
-        QPointF b(check(point_to_pixel_(QPointF(k + step*1, qreal(next_1))))),
-                c(check(point_to_pixel_(QPointF(k + step*2, qreal(next_2))))),
-                d(check(point_to_pixel_(QPointF(k + step*3, qreal(next_3)))));
+    curve_renderer::job j;
 
-        path.cubicTo(b, c, d);
-    }
+    j.size = size();
+    j.color = curve_color();
+    j.generation = ++curve_generation;
 
-    painter.drawPath(path);
-#else
-    static constexpr int line_length_pixels = 3;
-    const qreal max = _config->maxInput();
-    const qreal step = clamp(line_length_pixels / c.x(), 5e-2, max);
-    QPointF prev = point_to_pixel(QPoint(0, 0));
-    for (qreal i = 0; i < max; i += step)
-    {
-        const qreal val = qreal(_config->get_value_no_save(i));
-        const QPointF cur = point_to_pixel(QPointF(i, val));
-        painter.drawLine(prev, cur);
-        prev = cur;
-    }
-    {
-        const qreal maxx = _config->maxInput();
-        const qreal maxy = qreal(_config->get_value_no_save(maxx));
-        painter.drawLine(QPointF(prev), point_to_pixel_(QPointF(maxx, maxy)));
-    }
-#endif
+    j.pixels.reserve(int(xs.size()) + 1);
+    j.pixels.push_back(point_to_pixel(QPointF(0, 0)));
+    for (unsigned i = 0; i + 2 < xs.size(); i += 3)
+        for (unsigned k = i; k < i + 3; k++)
+            j.pixels.push_back(check(point_to_pixel_(QPointF(xs[k], qreal(ys[k])))));
 
+    // prevent topward and rightward artifacts
     const QRect r1(pixel_bounds.left(), 0, width() - pixel_bounds.left(), pixel_bounds.top()),
                 r2(pixel_bounds.right(), 0, width() - pixel_bounds.right(), pixel_bounds.bottom());
+    j.clip = QRegion(rect()).subtracted(r1).subtracted(r2);
 
-    // prevent topward artifacts the lazy way
-    painter.fillRect(r1, widget_bg_color);
-    // same for rightward artifacts
-    painter.fillRect(r2, widget_bg_color);
+    renderer.render(std::move(j));
+}
+
+void spline_widget::set_curve(const QImage& image, unsigned generation)
+{
+    // a newer one is on its way
+    if (generation != curve_generation)
+        return;
+
+    _curve = image;
+    compose();
+    update();
+}
+
+void spline_widget::compose()
+{
+    _function = _background;
+    QPainter painter(&_function);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    const points_t points = _config->get_points();
+
+    if (moving_control_point_idx >= 0 &&
+        moving_control_point_idx < points.size())
+    {
+        const QPen pen(Qt::white, 1, Qt::SolidLine, Qt::FlatCap);
+        const QPointF prev_ = point_to_pixel(QPointF(0, 0));
+        QPoint prev(iround(prev_.x()), iround(prev_.y()));
+        for (int i = 0; i < points.size(); i++)
+        {
+            const QPointF tmp_ = point_to_pixel(points[i]);
+            const QPoint tmp(iround(tmp_.x()), iround(tmp_.y()));
+            drawLine(painter, prev, tmp, pen);
+            prev = tmp;
+        }
+    }
+
+    // possibly still for the previous size until the new one arrives
+    if (_curve.size() == _function.size())
+        painter.drawImage(0, 0, _curve);
 
     const int alpha = !isEnabled() ? 64 : 120;
     if (!_preview_only)
@@ -274,6 +276,12 @@ void spline_widget::drawFunction()
     }
 }
 
+QRect spline_widget::marker_rect(const QPoint& pt)
+{
+    constexpr int sz = point_size + 2;
+    return QRect(pt.x() - sz, pt.y() - sz, sz * 2 + 1, sz * 2 + 1);
+}
+
 void spline_widget::paintEvent(QPaintEvent *e)
 {
     if (!_config)
@@ -281,15 +289,10 @@ void spline_widget::paintEvent(QPaintEvent *e)
 
     QPainter p(this);
 
-    if (!_background.isNull())
-    {
-        if (_background.size() != size())
-        {
-            _background = QPixmap();
-            _function = QPixmap();
-        }
-    }
-    else
+    if (!_background.isNull() && _background.size() != size())
+        _background = QPixmap();
+
+    if (_background.isNull())
     {
         _draw_function = true;
         drawBackground();
@@ -298,17 +301,44 @@ void spline_widget::paintEvent(QPaintEvent *e)
     if (_draw_function)
     {
         _draw_function = false;
-        drawFunction();
+        request_curve();
+        // the control points right away, the curve once it's rendered
+        compose();
     }
 
-    p.drawPixmap(e->rect(), _function);
+    p.drawPixmap(e->rect(), _function, e->rect());
 
     // If the Tracker is active, the 'Last Point' it requested is recorded.
     // Show that point on the graph, with some lines to assist.
     // This new feature is very handy for tweaking the curves!
     QPointF last;
     if (_config->get_last_value(last) && isEnabled())
-        drawPoint(p, point_to_pixel(last), QColor(255, 0, 0, 120));
+    {
+        const QPoint pt = point_to_pixel(last);
+        drawPoint(p, pt, QColor(255, 0, 0, 120));
+        _last_marker = marker_rect(pt);
+    }
+    else
+        _last_marker = QRect();
+}
+
+void spline_widget::update_last_value()
+{
+    if (!_config)
+        return;
+
+    QRect r;
+    QPointF last;
+    if (_config->get_last_value(last) && isEnabled())
+        r = marker_rect(point_to_pixel(last));
+
+    if (r != _last_marker)
+    {
+        if (!_last_marker.isNull())
+            update(_last_marker);
+        if (!r.isNull())
+            update(r);
+    }
 }
 
 void spline_widget::drawPoint(QPainter& painter, const QPointF& pos, const QColor& colBG, const QColor& border)
@@ -575,14 +605,20 @@ void spline_widget::update_range()
     const int mwl = 40, mhl = 20;
     const int mwr = 15, mhr = 35;
 
-    pixel_bounds = QRect(mwl, mhl, (w - mwl - mwr), (h - mhl - mhr));
-    c = QPointF(pixel_bounds.width() / _config->max_input(), pixel_bounds.height() / _config->max_output());
-    _draw_function = true;
+    const QRect bounds(mwl, mhl, (w - mwl - mwr), (h - mhl - mhr));
+    const QPointF c_(bounds.width() / _config->max_input(), bounds.height() / _config->max_output());
 
-    _background = QPixmap();
-    _function = QPixmap();
+    // the grid only depends on these. the curve gets redone regardless.
+    if (bounds != pixel_bounds || c_ != c)
+    {
+        pixel_bounds = bounds;
+        c = c_;
+        _background = QPixmap();
+    }
 
-    repaint();
+    _draw_function = true;
+
+    update();
 }
 
 bool spline_widget::point_within_pixel(const QPointF& pt, const QPoint &pixel)
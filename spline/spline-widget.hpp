@@ -10,6 +10,7 @@
 #pragma once
 
 #include "spline.hpp"
+#include "curve-renderer.hpp"
 #include "api/plugin-api.hpp"
 #include "options/options.hpp"
 using namespace options;
@@ -17,6 +18,8 @@ using namespace options;
 #include "export.hpp"
 
 #include <QWidget>
+#include <QImage>
+#include <QPixmap>
 #include <QRect>
 #include <QPoint>
 #include <QPointF>
@@ -56,8 +59,13 @@ public:
 
     void set_snap(double x, double y) { snap_x = x; snap_y = y; }
     void get_snap(double& x, double& y) const { x = snap_x; y = snap_y; }
+
+    // only repaints around the tracking marker, if it moved
+    void update_last_value();
 public slots:
     void reload_spline();
+signals:
+    void curve_rendered(const QImage& image, unsigned generation);
 protected slots:
     void paintEvent(QPaintEvent *e) override;
     void mousePressEvent(QMouseEvent *e) override;
@@ -69,7 +77,11 @@ private:
     bool is_in_bounds(const QPoint& pos) const;
 
     void drawBackground();
-    void drawFunction();
+    QColor curve_color() const;
+    void request_curve();
+    void set_curve(const QImage& image, unsigned generation);
+    void compose();
+    static QRect marker_rect(const QPoint& pt);
     void drawPoint(QPainter& painter, const QPointF& pt, const QColor& colBG, const QColor& border = QColor(50, 100, 120, 200));
     void drawLine(QPainter& painter, const QPoint& start, const QPoint& end, const QPen& pen);
     bool point_within_pixel(const QPointF& pt, const QPoint& pixel);
@@ -87,8 +99,12 @@ private:
     QPointF c;
     base_spline* _config;
 
+    // grid, then the curve from the renderer, then both plus the control points
     QPixmap _background;
+    QImage _curve;
     QPixmap _function;
+    QRect _last_marker;
+    unsigned curve_generation = 0;
     QColor spline_color;
     QColor widget_bg_color = palette().background().color();
 
@@ -103,4 +119,9 @@ private:
     bool _draw_function, _preview_only;
 
     static constexpr int point_size = 4;
+
+    // last, so that it's gone before anything it could call into
+    curve_renderer::client renderer {
+        [this](const QImage& image, unsigned generation) { emit curve_rendered(image, generation); }
+    };
 };
@@ -13,6 +13,7 @@
 #include <cmath>
 #include <memory>
 #include <cinttypes>
+#include <climits>
 #include <utility>
 
 #include <QObject>
@@ -24,9 +25,19 @@
 
 #include <QDebug>
 
+#if defined __AVX2__
+#   include <immintrin.h>
+#   define SPLINE_AVX2
+#   define SPLINE_SSE2
+#elif defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SPLINE_SSE2
+#endif
+
 using namespace spline_detail;
 
 constexpr std::size_t spline::value_count;
+constexpr unsigned lut::value_count;
 
 spline::spline(const QString& name, const QString& axis_name, Axis axis) :
     axis(axis)
@@ -43,9 +54,11 @@ spline::~spline()
         QObject::disconnect(connection);
         QObject::disconnect(conn_maxx);
         QObject::disconnect(conn_maxy);
+        QObject::disconnect(conn_curve);
         connection = QMetaObject::Connection();
         conn_maxx = QMetaObject::Connection();
         conn_maxy = QMetaObject::Connection();
+        conn_curve = QMetaObject::Connection();
     }
 }
 
@@ -53,7 +66,6 @@ spline::spline() : spline("", "", Axis(-1)) {}
 
 void spline::set_tracking_active(bool value)
 {
-    QMutexLocker l(&_mutex);
     activep = value;
 }
 
@@ -66,42 +78,51 @@ bundle spline::get_bundle()
 void spline::clear()
 {
     QMutexLocker l(&_mutex);
-    s->points = points_t();
     validp = false;
+    s->points = points_t();
+    if (!validp)
+        (void) update_interp_data();
 }
 
 float spline::get_value(double x)
 {
-    QMutexLocker foo(&_mutex);
-
     const float ret = get_value_no_save(x);
-    last_input_value.setX(std::fabs(x));
-    last_input_value.setY(double(std::fabs(ret)));
+    last_input_x = std::fabs(x);
+    last_input_y = double(std::fabs(ret));
     return ret;
 }
 
 float spline::get_value_no_save(double x) const
 {
-    return const_cast<spline&>(*this).get_value_no_save_internal(x);
+    return get_lut()->get_value(x);
 }
 
-float spline::get_value_no_save_internal(double x)
+void spline::get_values(const double* xs, float* out, std::size_t n) const
 {
-    QMutexLocker foo(&_mutex);
+    // same curve for the whole batch even if it gets edited meanwhile
+    get_lut()->get_values(xs, out, n);
+}
+
+std::shared_ptr<const lut> spline::get_lut() const
+{
+    std::shared_ptr<const lut> ret = std::atomic_load(&cur_lut);
+
+    if (unlikely(!ret))
+    {
+        // only before the first evaluation after set_bundle()
+        QMutexLocker l(&_mutex);
+
+        ret = std::atomic_load(&cur_lut);
+        if (!ret)
+            ret = const_cast<spline&>(*this).update_interp_data();
+    }
 
-    float  q  = float(x * bucket_size_coefficient(s->points));
-    int    xi = (int)q;
-    float  yi = get_value_internal(xi);
-    float  yiplus1 = get_value_internal(xi+1);
-    float  f = (q-xi);
-    float  ret = yiplus1 * f + yi * (1.0f - f); // at least do a linear interpolation.
     return ret;
 }
 
 warn_result_unused bool spline::get_last_value(QPointF& point)
 {
-    QMutexLocker foo(&_mutex);
-    point = last_input_value;
+    point = QPointF(last_input_x, last_input_y);
     return activep;
 }
 
@@ -111,18 +132,134 @@ static T signum(T val)
     return (T(0) < val) - (val < T(0));
 }
 
-float spline::get_value_internal(int x)
+lut::lut() : data(value_count, float(-16))
 {
-    if (!validp)
+}
+
+lut::lut(std::vector<knot> knots) : knots(std::move(knots))
+{
+}
+
+float lut::get_monotone_value(double x) const
+{
+    const double ax = std::fabs(x);
+    double ret;
+
+    if (ax <= knots.front().x)
+        ret = knots.front().y;
+    else if (ax >= knots.back().x)
+        ret = knots.back().y;
+    else
     {
-        update_interp_data();
-        validp = true;
+        const auto it = std::upper_bound(knots.cbegin(), knots.cend(), ax,
+                                         [](double x, const knot& k) { return x < k.x; });
+        const knot& k0 = it[-1];
+        const knot& k1 = it[0];
+
+        const double h = k1.x - k0.x;
+        const double t = (ax - k0.x) / h, t2 = t*t, t3 = t2*t;
+
+        ret = (2*t3 - 3*t2 + 1) * k0.y + (t3 - 2*t2 + t) * h * k0.m
+            + (-2*t3 + 3*t2) * k1.y + (t3 - t2) * h * k1.m;
     }
 
-    const float sign = signum(x);
-    x = std::abs(x);
-    const float ret_ = data[std::min(unsigned(x), unsigned(value_count)-1u)];
-    return sign * clamp(ret_, 0, 1000);
+    return signum(float(x)) * float(clamp(ret, 0, 1000));
+}
+
+// no branches, so that batches can get vectorized
+static inline float sample(const float* data, double c, double x)
+{
+    const auto at = [data](int x) {
+        const float sign = signum(x);
+        // std::abs(INT_MIN) overflows, and nan gets converted to that
+        const unsigned abs_x = x < 0 ? 0u - unsigned(x) : unsigned(x);
+        return sign * data[std::min(abs_x, lut::value_count-1u)];
+    };
+
+    const float q = float(x * c);
+    const int xi = (int)q;
+    const float yi = at(xi);
+    const float yiplus1 = at(xi+1);
+    const float f = (q-xi);
+    return yiplus1 * f + yi * (1.0f - f); // at least do a linear interpolation.
+}
+
+float lut::get_value(double x) const
+{
+    if (!knots.empty())
+        return get_monotone_value(x);
+
+    return sample(data.data(), c, x);
+}
+
+void lut::get_values(const double* xs, float* out, std::size_t n) const
+{
+    if (!knots.empty())
+    {
+        for (std::size_t i = 0; i < n; i++)
+            out[i] = get_monotone_value(xs[i]);
+        return;
+    }
+
+    const float* const data_ = data.data();
+    const double c_ = c;
+    std::size_t i = 0;
+
+#if defined SPLINE_SSE2
+    // four at a time, same arithmetic as sample(). only the table
+    // lookups are scalar short of avx2's gather.
+    {
+        const __m128d cv = _mm_set1_pd(c_);
+        const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi32(1);
+        const __m128i last = _mm_set1_epi32(int(value_count - 1));
+
+        const auto signum_ = [zero](__m128i x) {
+            return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_cmplt_epi32(x, zero), _mm_cmpgt_epi32(x, zero)));
+        };
+
+        // the min is unsigned like in sample(). nan and anything out of
+        // int range converts to INT_MIN, which stays negative after abs.
+        const auto index = [=](__m128i x) {
+#if defined SPLINE_AVX2
+            return _mm_min_epu32(_mm_abs_epi32(x), last);
+#else
+            const __m128i bias = _mm_set1_epi32(INT_MIN);
+            const __m128i m = _mm_srai_epi32(x, 31);
+            x = _mm_sub_epi32(_mm_xor_si128(x, m), m);
+            const __m128i gt = _mm_cmpgt_epi32(_mm_xor_si128(x, bias), _mm_xor_si128(last, bias));
+            return _mm_or_si128(_mm_andnot_si128(gt, x), _mm_and_si128(gt, last));
+#endif
+        };
+
+        const auto at = [=](__m128i x) {
+            const __m128i k = index(x);
+#if defined SPLINE_AVX2
+            const __m128 y = _mm_i32gather_ps(data_, k, 4);
+#else
+            alignas(16) std::int32_t k_[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(k_), k);
+            const __m128 y = _mm_setr_ps(data_[k_[0]], data_[k_[1]], data_[k_[2]], data_[k_[3]]);
+#endif
+            return _mm_mul_ps(signum_(x), y);
+        };
+
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 q = _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(xs + i), cv)),
+                                           _mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(xs + i + 2), cv)));
+            const __m128i xi = _mm_cvttps_epi32(q);
+            const __m128 yi = at(xi);
+            const __m128 yiplus1 = at(_mm_add_epi32(xi, one));
+            const __m128 f = _mm_sub_ps(q, _mm_cvtepi32_ps(xi));
+
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(yiplus1, f),
+                                              _mm_mul_ps(yi, _mm_sub_ps(_mm_set1_ps(1), f))));
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+        out[i] = sample(data_, c_, xs[i]);
 }
 
 void spline::add_lone_point()
@@ -163,93 +300,328 @@ bool spline::sort_fn(const QPointF& one, const QPointF& two)
     return one.x() < two.x();
 }
 
-void spline::update_interp_data()
+void spline::interp_segments(const QList<QPointF>& points, int first, int last, double c,
+                             std::vector<float>& data, unsigned lo, unsigned hi)
 {
-    points_t points = s->points;
-    ensure_valid(points);
-    const int sz = points.size();
+    const double c_interp = c * 30;
 
-    const double maxx = max_input();
+    for (int i = first; i <= last; i++)
+    {
+        const QPointF p0 = ensure_in_bounds(points, i - 1);
+        const QPointF p1 = ensure_in_bounds(points, i + 0);
+        const QPointF p2 = ensure_in_bounds(points, i + 1);
+        const QPointF p3 = ensure_in_bounds(points, i + 2);
+        const double p0_x = p0.x(), p1_x = p1.x(), p2_x = p2.x(), p3_x = p3.x();
+        const double p0_y = p0.y(), p1_y = p1.y(), p2_y = p2.y(), p3_y = p3.y();
+
+        const double cx[4] = {
+            2 * p1_x, // 1
+            -p0_x + p2_x, // t
+            2 * p0_x - 5 * p1_x + 4 * p2_x - p3_x, // t^2
+            -p0_x + 3 * p1_x - 3 * p2_x + p3_x, // t3
+        };
+
+        const double cy[4] =
+        {
+            2 * p1_y, // 1
+            -p0_y + p2_y, // t
+            2 * p0_y - 5 * p1_y + 4 * p2_y - p3_y, // t^2
+            -p0_y + 3 * p1_y - 3 * p2_y + p3_y, // t3
+        };
 
-    if (sz == 0)
-        points.prepend(QPointF(maxx, max_output()));
+        // multiplier helps fill in all the x's needed
+        const unsigned end = int(c_interp * (p2_x - p1_x)) + 1;
 
-    std::stable_sort(points.begin(), points.begin() + sz, sort_fn);
+        for (unsigned k = 0; k <= end; k++)
+        {
+            const double t = k / double(end);
+            const double t2 = t*t;
+            const double t3 = t*t*t;
 
-    const double c = bucket_size_coefficient(points);
-    const double c_interp = c * 30;
+            const int x = int(.5 * c * (cx[0] + cx[1] * t + cx[2] * t2 + cx[3] * t3));
+            const float y = float(.5 * (cy[0] + cy[1] * t + cy[2] * t2 + cy[3] * t3));
 
-    for (unsigned i = 0; i < value_count; i++)
-        data[i] = -16;
+            if (unsigned(x) >= lo && unsigned(x) <= hi)
+                data[unsigned(x)] = y;
+        }
+    }
+}
 
-    if (sz < 2)
+void spline::forward_fill(std::vector<float>& data, unsigned lo, unsigned hi)
+{
+    // cells before `lo' are already clamped. that doesn't matter since
+    // a cell copied from one gets clamped anyway.
+    float last = lo > 0 ? data[lo - 1] : 0;
+    for (unsigned i = lo; i <= hi; i++)
     {
-        if (points[0].x() - 1e-2 < maxx)
+        if (data[i] == -16)
+            data[i] = last;
+        last = data[i];
+        data[i] = clamp(data[i], 0, 1000);
+    }
+}
+
+// buckets segment i can write to. with uneven spacing x(t) overshoots
+// past the segment's own endpoints, so find its extrema.
+std::pair<int, int> spline::segment_extent(const QList<QPointF>& points, int i, double c)
+{
+    const double p0_x = ensure_in_bounds(points, i - 1).x();
+    const double p1_x = ensure_in_bounds(points, i + 0).x();
+    const double p2_x = ensure_in_bounds(points, i + 1).x();
+    const double p3_x = ensure_in_bounds(points, i + 2).x();
+
+    const double cx[4] = {
+        2 * p1_x,
+        -p0_x + p2_x,
+        2 * p0_x - 5 * p1_x + 4 * p2_x - p3_x,
+        -p0_x + 3 * p1_x - 3 * p2_x + p3_x,
+    };
+
+    const auto x = [&](double t) {
+        return .5 * c * (cx[0] + cx[1] * t + cx[2] * t*t + cx[3] * t*t*t);
+    };
+
+    double min = std::min(x(0), x(1)), max = std::max(x(0), x(1));
+
+    // roots of x'(t) = cx[1] + 2 cx[2] t + 3 cx[3] t^2
+    double roots[2];
+    unsigned nroots = 0;
+
+    if (std::fabs(cx[3]) > 1e-12)
+    {
+        const double d = 4 * cx[2] * cx[2] - 12 * cx[3] * cx[1];
+        if (d >= 0)
         {
-            const double x = points[0].x();
-            const double y = points[0].y();
-            const int max = clamp(iround(x * c), 1, value_count-1);
-            for (int k = 0; k <= max; k++)
-            {
-                if (k < value_count)
-                    data[unsigned(k)] = float(y * k / max);
-            }
+            roots[nroots++] = (-2 * cx[2] + std::sqrt(d)) / (6 * cx[3]);
+            roots[nroots++] = (-2 * cx[2] - std::sqrt(d)) / (6 * cx[3]);
         }
     }
-    else
-    {
-        if (points[0].x() > 1e-2 && points[0].x() <= maxx)
-            points.push_front(QPointF(0, 0));
+    else if (std::fabs(cx[2]) > 1e-12)
+        roots[nroots++] = -cx[1] / (2 * cx[2]);
 
-        for (int i = 0; i < sz; i++)
+    for (unsigned k = 0; k < nroots; k++)
+    {
+        if (roots[k] > 0 && roots[k] < 1)
         {
-            const QPointF p0 = ensure_in_bounds(points, i - 1);
-            const QPointF p1 = ensure_in_bounds(points, i + 0);
-            const QPointF p2 = ensure_in_bounds(points, i + 1);
-            const QPointF p3 = ensure_in_bounds(points, i + 2);
-            const double p0_x = p0.x(), p1_x = p1.x(), p2_x = p2.x(), p3_x = p3.x();
-            const double p0_y = p0.y(), p1_y = p1.y(), p2_y = p2.y(), p3_y = p3.y();
-
-            const double cx[4] = {
-                2 * p1_x, // 1
-                -p0_x + p2_x, // t
-                2 * p0_x - 5 * p1_x + 4 * p2_x - p3_x, // t^2
-                -p0_x + 3 * p1_x - 3 * p2_x + p3_x, // t3
-            };
-
-            const double cy[4] =
-            {
-                2 * p1_y, // 1
-                -p0_y + p2_y, // t
-                2 * p0_y - 5 * p1_y + 4 * p2_y - p3_y, // t^2
-                -p0_y + 3 * p1_y - 3 * p2_y + p3_y, // t3
-            };
+            min = std::min(min, x(roots[k]));
+            max = std::max(max, x(roots[k]));
+        }
+    }
+
+    // one bucket of slack for rounding
+    return { int(std::floor(min)) - 1, int(std::floor(max)) + 1 };
+}
+
+// redo only the buckets that the segments next to the edited points
+// wrote to, in the old or the new curve. segment i goes from points[i]
+// to points[i+1] but also depends on points[i-1] and points[i+2].
+std::shared_ptr<lut> spline::update_lut_range(const lut& old, const QList<QPointF>& points, int sz, double c)
+{
+    const QList<QPointF>& old_points = lut_points;
+    const int n = points.size(), m = old_points.size();
+    const int old_sz = lut_segments;
+
+    // not QPointF::operator==, it's fuzzy
+    const auto same = [](const QPointF& a, const QPointF& b) {
+        return a.x() == b.x() && a.y() == b.y();
+    };
+
+    int a = 0;
+    while (a < n && a < m && same(points[a], old_points[a]))
+        a++;
+
+    std::shared_ptr<lut> ret = std::make_shared<lut>(old);
+
+    if (a == n && a == m)
+        return ret;
+
+    int k = 0;
+    while (k < n - a && k < m - a && same(points[n-1-k], old_points[m-1-k]))
+        k++;
+
+    // last changed index on either side. less than `a' for pure insertion/removal.
+    const int b_new = n - 1 - k, b_old = m - 1 - k;
+
+    const int first = std::max(a - 2, 0);
+    const int last_new = std::min(b_new + 1, sz - 1), last_old = std::min(b_old + 1, old_sz - 1);
+
+    int lo = int(value_count), hi = -1;
+
+    for (int i = first; i <= last_new; i++)
+    {
+        const std::pair<int, int> e = segment_extent(points, i, c);
+        lo = std::min(lo, e.first), hi = std::max(hi, e.second);
+    }
+    for (int i = first; i <= last_old; i++)
+    {
+        const std::pair<int, int> e = segment_extent(old_points, i, c);
+        lo = std::min(lo, e.first), hi = std::max(hi, e.second);
+    }
+
+    // before the first and past the last point, buckets get forward-filled
+    if (first == 0)
+        lo = 0;
+    if (last_new == sz - 1 || last_old == old_sz - 1)
+        hi = int(value_count) - 1;
+
+    lo = clamp(lo, 0, int(value_count) - 1);
+    hi = clamp(hi, 0, int(value_count) - 1);
+
+    if (lo > hi)
+        return nullptr;
+
+    std::vector<float>& data = ret->data;
+    std::fill(data.begin() + lo, data.begin() + hi + 1, float(-16));
+
+    // unchanged segments can overlap the range too. keep the order,
+    // the last one to write a bucket wins.
+    for (int i = 0; i < sz; i++)
+    {
+        const std::pair<int, int> e = segment_extent(points, i, c);
+        if (e.second >= lo && e.first <= hi)
+            interp_segments(points, i, i, c, data, unsigned(lo), unsigned(hi));
+    }
 
-            // multiplier helps fill in all the x's needed
-            const unsigned end = int(c_interp * (p2_x - p1_x)) + 1;
+    forward_fill(data, unsigned(lo), unsigned(hi));
 
-            for (unsigned k = 0; k <= end; k++)
+    return ret;
+}
+
+// fritsch-carlson. doesn't overshoot between points, unlike catmull-rom.
+std::shared_ptr<lut> spline::make_monotone(const QList<QPointF>& points)
+{
+    std::vector<lut::knot> k;
+    k.reserve(unsigned(points.size()));
+
+    for (const QPointF& p : points)
+    {
+        // same x, different y. the later one wins like in the sampled curve.
+        if (!k.empty() && p.x() - k.back().x < 1e-6)
+            k.back() = { k.back().x, p.y(), 0 };
+        else
+            k.push_back({ p.x(), p.y(), 0 });
+    }
+
+    const unsigned n = k.size();
+
+    if (n >= 2)
+    {
+        std::vector<double> d(n - 1);
+        for (unsigned i = 0; i + 1 < n; i++)
+            d[i] = (k[i+1].y - k[i].y) / (k[i+1].x - k[i].x);
+
+        k[0].m = d[0];
+        k[n-1].m = d[n-2];
+        for (unsigned i = 1; i + 1 < n; i++)
+            k[i].m = d[i-1] * d[i] <= 0 ? 0 : (d[i-1] + d[i]) * .5;
+
+        for (unsigned i = 0; i + 1 < n; i++)
+        {
+            if (d[i] == 0)
             {
-                const double t = k / double(end);
-                const double t2 = t*t;
-                const double t3 = t*t*t;
+                k[i].m = 0, k[i+1].m = 0;
+                continue;
+            }
 
-                const int x = int(.5 * c * (cx[0] + cx[1] * t + cx[2] * t2 + cx[3] * t3));
-                const float y = float(.5 * (cy[0] + cy[1] * t + cy[2] * t2 + cy[3] * t3));
+            const double a = k[i].m / d[i], b = k[i+1].m / d[i];
+            const double s = a*a + b*b;
 
-                if (unsigned(x) < value_count)
-                    data[x] = y;
+            if (s > 9)
+            {
+                const double t = 3 / std::sqrt(s);
+                k[i].m = t * a * d[i];
+                k[i+1].m = t * b * d[i];
             }
         }
     }
 
-    float last = 0;
-    for (unsigned i = 0; i < unsigned(value_count); i++)
+    return std::make_shared<lut>(std::move(k));
+}
+
+// call with the mutex held
+std::shared_ptr<const lut> spline::update_interp_data()
+{
+    // ensure_valid() may store fixed-up points, which gets us back into
+    // invalidate_settings(). the points we use here are already fixed up.
+    rebuilding = true;
+
+    points_t points = s->points;
+    ensure_valid(points); // this also sorts them
+    const int sz = points.size();
+
+    const double maxx = max_input();
+
+    if (sz == 0)
+        points.prepend(QPointF(maxx, max_output()));
+
+    const double c = bucket_size_coefficient(points);
+
+    bool prepended = false;
+
+    if (sz >= 2 && points[0].x() > 1e-2 && points[0].x() <= maxx)
     {
-        if (data[i] == -16)
-            data[i] = last;
-        last = data[i];
+        points.push_front(QPointF(0, 0));
+        prepended = true;
     }
+
+    std::shared_ptr<lut> ret;
+    const bool monotone = s->opts.curve == axis_opts::curve_monotone;
+
+    if (monotone)
+    {
+        // the sampled curve's lone point case is a line from the origin too
+        if (!prepended && points[0].x() > 1e-2)
+            points.push_front(QPointF(0, 0));
+
+        ret = make_monotone(points);
+    }
+    else
+    {
+        const std::shared_ptr<const lut> old = std::atomic_load(&cur_lut);
+
+        if (old && sz >= 2 && lut_segments >= 2 && lut_c == c && lut_prepended == prepended)
+            ret = update_lut_range(*old, points, sz, c);
+    }
+
+    if (!ret)
+    {
+        ret = std::make_shared<lut>();
+        std::vector<float>& data = ret->data;
+
+        if (sz < 2)
+        {
+            if (points[0].x() - 1e-2 < maxx)
+            {
+                const double x = points[0].x();
+                const double y = points[0].y();
+                const int max = clamp(iround(x * c), 1, value_count-1);
+                for (int k = 0; k <= max; k++)
+                {
+                    if (k < value_count)
+                        data[unsigned(k)] = float(y * k / max);
+                }
+            }
+        }
+        else
+            interp_segments(points, 0, sz - 1, c, data, 0, value_count - 1);
+
+        forward_fill(data, 0, value_count - 1);
+    }
+
+    // nothing to update in place next time for the monotone curve
+    lut_points = monotone ? points_t() : std::move(points);
+    lut_c = c;
+    lut_segments = monotone ? 0 : sz;
+    lut_prepended = prepended;
+
+    // evaluation has always used the stored points for this, not the fixed-up ones
+    ret->c = bucket_size_coefficient(s->points);
+
+    std::atomic_store(&cur_lut, std::shared_ptr<const lut>(ret));
+    validp = true;
+    rebuilding = false;
+
+    return ret;
 }
 
 void spline::remove_point(int i)
@@ -262,8 +634,10 @@ void spline::remove_point(int i)
     if (i >= 0 && i < sz)
     {
         points.erase(points.begin() + i);
-        s->points = points;
         validp = false;
+        s->points = points;
+        if (!validp)
+            (void) update_interp_data();
     }
 }
 
@@ -274,8 +648,10 @@ void spline::add_point(QPointF pt)
     points_t points = s->points;
     points.push_back(pt);
     std::stable_sort(points.begin(), points.end(), sort_fn);
-    s->points = points;
     validp = false;
+    s->points = points;
+    if (!validp)
+        (void) update_interp_data();
 }
 
 void spline::add_point(double x, double y)
@@ -296,8 +672,10 @@ void spline::move_point(int idx, QPointF pt)
         points[idx] = pt;
         // we don't allow points to be reordered, but sort due to possible caller logic error
         std::stable_sort(points.begin(), points.end(), sort_fn);
-        s->points = points;
         validp = false;
+        s->points = points;
+        if (!validp)
+            (void) update_interp_data();
     }
 }
 
@@ -333,6 +711,9 @@ void spline::invalidate_settings()
     QMutexLocker l(&_mutex);
     validp = false;
 
+    if (!rebuilding)
+        (void) update_interp_data();
+
     emit s->recomputed();
 }
 
@@ -351,6 +732,7 @@ void spline::set_bundle(bundle b, const QString& axis_name, Axis axis)
             QObject::disconnect(connection);
             QObject::disconnect(conn_maxx);
             QObject::disconnect(conn_maxy);
+            QObject::disconnect(conn_curve);
         }
 
         if (b)
@@ -363,9 +745,12 @@ void spline::set_bundle(bundle b, const QString& axis_name, Axis axis)
                                          ctx.get(), [&](double) { invalidate_settings(); });
             conn_maxy = QObject::connect(&s->opts.clamp_y_, base_value::value_changed<int>(),
                                          ctx.get(), [&](double) { invalidate_settings(); });
+            conn_curve = QObject::connect(&s->opts.curve, base_value::value_changed<int>(),
+                                          ctx.get(), [&](int) { invalidate_settings(); });
         }
 
         validp = false;
+        std::atomic_store(&cur_lut, std::shared_ptr<const lut>());
     }
 }
 
@@ -421,9 +806,12 @@ void spline::ensure_valid(QList<QPointF>& the_points)
         QPointF& pt(list[i]);
 
         const bool overlap = progn(
-            for (int j = 0; j < i; j++)
+            // sorted by x, so only the closest few can be in range
+            for (int j = i - 1; j >= 0; j--)
             {
                 const QPointF& pt2(list[j]);
+                if (pt.x() - pt2.x() >= maxx / 500.)
+                    break;
                 const QPointF tmp(pt - pt2);
                 const double dist_sq = QPointF::dotProduct(tmp, tmp);
                 const double overlap = maxx / 500.;
@@ -449,7 +837,8 @@ void spline::ensure_valid(QList<QPointF>& the_points)
         the_points = std::move(ret_list);
     }
 
-    last_input_value = QPointF(0, 0);
+    last_input_x = 0;
+    last_input_y = 0;
     activep = false;
 }
 
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "compat/copyable-mutex.hpp"
+#include "compat/copyable-atomic.hpp"
 #include "options/options.hpp"
 #include "compat/util.hpp"
 using namespace options;
@@ -47,6 +48,30 @@ public:
     ~settings() override;
 };
 
+// the evaluated curve. never modified after being published, so evaluating
+// it needs no locking; the spline swaps in a new one on every change.
+struct OTR_SPLINE_EXPORT lut final
+{
+    static constexpr unsigned value_count = 4096;
+
+    struct knot { double x, y, m; };
+
+    // either sampled, 16 KB
+    std::vector<float> data; // already clamped to [0, 1000]
+    double c = 0; // input to bucket index
+
+    // or a monotone cubic through the points, a few hundred bytes
+    std::vector<knot> knots;
+
+    lut();
+    explicit lut(std::vector<knot> knots);
+    float get_value(double x) const;
+    void get_values(const double* xs, float* out, std::size_t n) const;
+
+private:
+    float get_monotone_value(double x) const;
+};
+
 } // ns spline_detail
 
 struct OTR_SPLINE_EXPORT base_spline_
@@ -55,6 +80,8 @@ struct OTR_SPLINE_EXPORT base_spline_
 
     virtual float get_value(double x) = 0;
     virtual float get_value_no_save(double x) const = 0;
+    // like get_value_no_save() for each of `xs', from one version of the curve
+    virtual void get_values(const double* xs, float* out, std::size_t n) const = 0;
 
     warn_result_unused virtual bool get_last_value(QPointF& point) = 0;
     virtual void set_tracking_active(bool value) = 0;
@@ -90,31 +117,49 @@ public:
 
 class OTR_SPLINE_EXPORT spline : public base_spline
 {
+    using lut = spline_detail::lut;
+
+    // opentrack-spline-bench checks partial rebuilds against full ones
+    friend struct spline_lut_bench;
+
     double bucket_size_coefficient(const QList<QPointF>& points) const;
-    void update_interp_data();
-    float get_value_internal(int x);
+    std::shared_ptr<const lut> update_interp_data();
+    static std::shared_ptr<lut> make_monotone(const QList<QPointF>& points);
+    std::shared_ptr<lut> update_lut_range(const lut& old, const QList<QPointF>& points, int sz, double c);
+    std::shared_ptr<const lut> get_lut() const;
     void add_lone_point();
-    float get_value_no_save_internal(double x);
     static bool sort_fn(const QPointF& one, const QPointF& two);
 
     static QPointF ensure_in_bounds(const QList<QPointF>& points, int i);
     static int element_count(const QList<QPointF>& points, double max_input);
+    static void interp_segments(const QList<QPointF>& points, int first, int last, double c,
+                                std::vector<float>& data, unsigned lo, unsigned hi);
+    static void forward_fill(std::vector<float>& data, unsigned lo, unsigned hi);
+    static std::pair<int, int> segment_extent(const QList<QPointF>& points, int i, double c);
 
     std::shared_ptr<spline_detail::settings> s;
-    QMetaObject::Connection connection, conn_maxx, conn_maxy;
+    QMetaObject::Connection connection, conn_maxx, conn_maxy, conn_curve;
+
+    static constexpr std::size_t value_count = lut::value_count;
 
-    static constexpr std::size_t value_count = 4096;
+    // only accessed through std::atomic_load() and std::atomic_store()
+    std::shared_ptr<const lut> cur_lut;
 
-    std::vector<float> data = std::vector<float>(value_count, float(-16));
+    // what `cur_lut' was built from, to only redo the part an edit touched
+    QList<QPointF> lut_points;
+    double lut_c = 0;
+    int lut_segments = 0;
+    bool lut_prepended = false;
 
     mutex _mutex { mutex::recursive };
-    QPointF last_input_value;
+    copyable_atomic<double> last_input_x, last_input_y;
     std::shared_ptr<QObject> ctx { std::make_shared<QObject>() };
 
     Axis axis = NonAxis;
 
-    bool activep = false;
+    copyable_atomic<bool> activep { false };
     bool validp = false;
+    bool rebuilding = false;
 
 public:
     void invalidate_settings();
@@ -135,6 +180,7 @@ public:
 
     float get_value(double x) override;
     float get_value_no_save(double x) const override;
+    void get_values(const double* xs, float* out, std::size_t n) const override;
     warn_result_unused bool get_last_value(QPointF& point) override;
 
     void add_point(QPointF pt) override;
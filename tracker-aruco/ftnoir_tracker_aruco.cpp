@@ -384,6 +384,8 @@ void aruco_tracker::run()
                 continue;
         }
 
+        const long long frame_time = Timer::now_nsecs();
+
         cv::cvtColor(color, grayscale, cv::COLOR_BGR2GRAY);
 
 #ifdef DEBUG_UNSHARP_MASKING
@@ -423,6 +425,7 @@ void aruco_tracker::run()
             set_last_roi();
             draw_centroid();
             set_rmat();
+            notify_new_sample(frame_time);
         }
         else
         {
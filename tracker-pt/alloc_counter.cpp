@@ -0,0 +1,54 @@
+#include "alloc_counter.h"
+
+#ifdef PT_DEBUG_ALLOCATIONS
+
+#include <opencv2/core.hpp>
+
+using namespace pt_impl;
+
+static thread_local unsigned nallocs = 0;
+
+namespace {
+
+// forwards to the usual allocator, which then frees the buffer itself
+struct counting_allocator final : cv::MatAllocator
+{
+    const cv::MatAllocator* const std_alloc = cv::Mat::getStdAllocator();
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data,
+                           size_t* step, int flags, cv::UMatUsageFlags usage) const override
+    {
+        // otherwise it's only wrapping memory that's already there
+        if (!data)
+            nallocs++;
+        return std_alloc->allocate(dims, sizes, type, data, step, flags, usage);
+    }
+
+    bool allocate(cv::UMatData* data, int flags, cv::UMatUsageFlags usage) const override
+    {
+        return std_alloc->allocate(data, flags, usage);
+    }
+
+    void deallocate(cv::UMatData* data) const override
+    {
+        std_alloc->deallocate(data);
+    }
+};
+
+} // ns
+
+alloc_counter::alloc_counter()
+{
+    static counting_allocator alloc;
+    static const bool once = (cv::Mat::setDefaultAllocator(&alloc), true);
+    (void) once;
+
+    start = nallocs;
+}
+
+unsigned alloc_counter::count() const
+{
+    return nallocs - start;
+}
+
+#endif
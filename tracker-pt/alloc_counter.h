@@ -0,0 +1,30 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+// asserts that frames don't allocate once their size stays the same
+//#define PT_DEBUG_ALLOCATIONS
+
+#ifdef PT_DEBUG_ALLOCATIONS
+
+namespace pt_impl {
+
+// counts image buffers allocated on the calling thread while it's alive.
+// opencv's own temporaries and std containers aren't seen, the former
+// aren't ours and the latter are reserved up front.
+class alloc_counter final
+{
+    unsigned start;
+public:
+    alloc_counter();
+    unsigned count() const;
+};
+
+} // ns pt_impl
+
+#endif
@@ -0,0 +1,264 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "blob_labeler.h"
+
+#include <algorithm>
+
+#if defined __AVX2__
+#   include <immintrin.h>
+#   define PT_LABELER_AVX2
+#elif defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define PT_LABELER_SSE2
+#endif
+
+#if defined _MSC_VER
+#   include <intrin.h>
+#endif
+
+using namespace pt_impl;
+
+constexpr unsigned blob_labeler::max_runs;
+
+static inline unsigned count_trailing_zeros(unsigned x)
+{
+#if defined _MSC_VER
+    unsigned long ret;
+    _BitScanForward(&ret, x);
+    return unsigned(ret);
+#else
+    return unsigned(__builtin_ctz(x));
+#endif
+}
+
+blob_labeler::blob_labeler()
+{
+    parent.reserve(max_runs);
+    stats.reserve(max_runs);
+    out.reserve(max_runs);
+}
+
+void blob_labeler::reserve(int width)
+{
+    // every other pixel lit
+    const unsigned n = unsigned(width / 2 + 1);
+
+    prev_runs.reserve(n);
+    cur_runs.reserve(n);
+}
+
+void blob_labeler::clear()
+{
+    out.clear();
+}
+
+void blob_labeler::label(const cv::Mat1b& frame_gray, int thres)
+{
+    clear();
+    (void) add(frame_gray, thres, cv::Rect(0, 0, frame_gray.cols, frame_gray.rows));
+}
+
+bool blob_labeler::add(const cv::Mat1b& frame_gray, int thres, const cv::Rect& roi)
+{
+    prev_runs.clear();
+    cur_runs.clear();
+    parent.clear();
+    stats.clear();
+    overflow = false;
+
+    // nothing's brighter than that
+    if (thres >= 255)
+        return true;
+
+    // the dimmest value that's lit
+    const unsigned char lo = (unsigned char) std::max(0, thres + 1);
+
+    for (int y = 0; y < roi.height && !overflow; y++)
+    {
+        prev_idx = 0;
+        scan_row(frame_gray.ptr(roi.y + y) + roi.x, y, roi.width, lo);
+        std::swap(prev_runs, cur_runs);
+        cur_runs.clear();
+    }
+
+    // edges of the window that aren't the frame's
+    const bool left = roi.x > 0, top = roi.y > 0,
+               right = roi.x + roi.width < frame_gray.cols,
+               bottom = roi.y + roi.height < frame_gray.rows;
+
+    bool ret = !overflow;
+
+    for (unsigned i = 0; i < parent.size(); i++)
+    {
+        if (parent[i] != i)
+            continue;
+
+        component c = stats[i];
+
+        if ((left && c.x0 == 0) || (top && c.y0 == 0) ||
+            (right && c.x1 == roi.width - 1) || (bottom && c.y1 == roi.height - 1))
+            ret = false;
+
+        c.x0 += roi.x; c.x1 += roi.x;
+        c.y0 += roi.y; c.y1 += roi.y;
+
+        if (out.size() == max_runs)
+        {
+            ret = false;
+            break;
+        }
+
+        out.push_back(c);
+    }
+
+    return ret;
+}
+
+// the mask has a bit for each pixel over the threshold. flips between
+// looking for the start and the end of a run until the chunk's done.
+#define PT_LABELER_CHUNK(mask, nbits)                               \
+    do {                                                            \
+        const unsigned all = ~0u >> (32 - (nbits));                 \
+        unsigned pos = 0;                                           \
+        for (;;)                                                    \
+        {                                                           \
+            const unsigned look = (in_run ? ~(mask) : (mask)) & all \
+                                  & (all << pos);                   \
+            if (!look)                                              \
+                break;                                              \
+            pos = count_trailing_zeros(look);                       \
+            if (in_run)                                             \
+                add_run(row, y, start, x + int(pos));               \
+            else                                                    \
+                start = x + int(pos);                               \
+            in_run = !in_run;                                       \
+        }                                                           \
+    } while (0)
+
+void blob_labeler::scan_row(const unsigned char* row, int y, int w, unsigned char lo)
+{
+    bool in_run = false;
+    int start = 0;
+    int x = 0;
+
+    // no unsigned byte comparison, but v >= lo is the same as max(v, lo) == v
+#if defined PT_LABELER_AVX2
+    {
+        const __m256i t = _mm256_set1_epi8(char(lo));
+
+        for (; x + 32 <= w; x += 32)
+        {
+            const __m256i v = _mm256_loadu_si256((const __m256i*)(row + x));
+            const unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(v, t), v)));
+
+            // most of an ir frame is dark
+            if (!mask && !in_run)
+                continue;
+
+            PT_LABELER_CHUNK(mask, 32);
+        }
+    }
+#elif defined PT_LABELER_SSE2
+    {
+        const __m128i t = _mm_set1_epi8(char(lo));
+
+        for (; x + 16 <= w; x += 16)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(row + x));
+            const unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, t), v)));
+
+            if (!mask && !in_run)
+                continue;
+
+            PT_LABELER_CHUNK(mask, 16);
+        }
+    }
+#endif
+
+    for (; x < w; x++)
+    {
+        const bool lit = row[x] >= lo;
+
+        if (lit == in_run)
+            continue;
+
+        if (in_run)
+            add_run(row, y, start, x);
+        else
+            start = x;
+
+        in_run = lit;
+    }
+
+    if (in_run)
+        add_run(row, y, start, w);
+}
+
+#undef PT_LABELER_CHUNK
+
+void blob_labeler::add_run(const unsigned char* row, int y, int x0, int x1)
+{
+    const unsigned label = unsigned(parent.size());
+
+    if (label == max_runs)
+    {
+        overflow = true;
+        return;
+    }
+
+    unsigned sum = 0;
+    for (int x = x0; x < x1; x++)
+        sum += row[x];
+
+    parent.push_back(label);
+    stats.push_back({ x0, y, x1 - 1, y, unsigned(x1 - x0), sum });
+    cur_runs.push_back({ x0, x1, label });
+
+    // runs in the row above sharing a column. both rows are sorted,
+    // so the ones ending left of this run can't touch the next one either.
+    while (prev_idx < prev_runs.size() && prev_runs[prev_idx].x1 <= x0)
+        prev_idx++;
+
+    for (unsigned i = prev_idx; i < prev_runs.size() && prev_runs[i].x0 < x1; i++)
+        unite(label, prev_runs[i].label);
+}
+
+unsigned blob_labeler::find(unsigned x)
+{
+    while (parent[x] != x)
+    {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+void blob_labeler::unite(unsigned a, unsigned b)
+{
+    a = find(a);
+    b = find(b);
+
+    if (a == b)
+        return;
+
+    // the older label stays the root, so that the order is by first pixel
+    if (b < a)
+        std::swap(a, b);
+
+    parent[b] = a;
+
+    component& c = stats[a];
+    const component& d = stats[b];
+
+    c.x0 = std::min(c.x0, d.x0);
+    c.y0 = std::min(c.y0, d.y0);
+    c.x1 = std::max(c.x1, d.x1);
+    c.y1 = std::max(c.y1, d.y1);
+    c.area += d.area;
+    c.sum += d.sum;
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace pt_impl {
+
+// thresholds and finds 4-connected components in a single pass over
+// the image, one row of runs at a time. nothing is written back.
+class blob_labeler final
+{
+public:
+    struct component
+    {
+        // bounding box, inclusive
+        int x0, y0, x1, y1;
+        unsigned area;
+        // of the grayscale values
+        unsigned sum;
+
+        cv::Rect rect() const { return cv::Rect(x0, y0, x1 - x0 + 1, y1 - y0 + 1); }
+    };
+
+    // pixels brighter than `thres'. components come out in order of
+    // their first pixel, same as a raster scan would find them.
+    void label(const cv::Mat1b& frame_gray, int thres);
+
+    // same, but only within `roi', adding to what's already there.
+    // false if a component touches the window's edge and could be
+    // larger than what was found, or if there were too many to keep.
+    bool add(const cv::Mat1b& frame_gray, int thres, const cv::Rect& roi);
+    void clear();
+
+    // so that frames up to this wide don't allocate
+    void reserve(int width);
+
+    blob_labeler();
+
+    const std::vector<component>& components() const { return out; }
+
+private:
+    // past this many, the rest of the image is skipped. that's noise,
+    // not points, and the buffers stay the same size.
+    static constexpr unsigned max_runs = 16384;
+
+    struct run
+    {
+        // [x0, x1)
+        int x0, x1;
+        unsigned label;
+    };
+
+    std::vector<run> prev_runs, cur_runs;
+    std::vector<unsigned> parent;
+    std::vector<component> stats, out;
+    unsigned prev_idx = 0;
+    bool overflow = false;
+
+    void scan_row(const unsigned char* row, int y, int w, unsigned char lo);
+    void add_run(const unsigned char* row, int y, int x0, int x1);
+    unsigned find(unsigned x);
+    void unite(unsigned a, unsigned b);
+};
+
+} // ns pt_impl
@@ -49,6 +49,8 @@ warn_result_unused Camera::result Camera::get_frame(cv::Mat& frame)
 
     if (new_frame)
     {
+        frame_time = Timer::now_nsecs();
+
         const double dt = t.elapsed_seconds();
         t.start();
 
@@ -60,12 +60,15 @@ struct Camera final
     operator bool() const { return cap && cap->isOpened(); }
 
     void set_fov(double value) { fov = value; }
+    // monotonic time (Timer::now_nsecs()) at which the last frame got grabbed
+    long long get_frame_time() const { return frame_time; }
 
 private:
     warn_result_unused bool _get_frame(cv::Mat& frame);
 
     double dt_mean;
     double fov;
+    long long frame_time = 0;
 
     Timer t;
 
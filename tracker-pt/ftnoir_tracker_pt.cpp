@@ -7,10 +7,13 @@
  */
 
 #include "ftnoir_tracker_pt.h"
+#include "alloc_counter.h"
 #include "compat/camera-names.hpp"
 #include "compat/math-imports.hpp"
+#include "compat/sleep.hpp"
 #include <QHBoxLayout>
 #include <cmath>
+#include <thread>
 #include <QDebug>
 #include <QFile>
 #include <QCoreApplication>
@@ -23,7 +26,7 @@ Tracker_PT::Tracker_PT() :
 {
     cv::setBreakOnError(true);
 
-    connect(s.b.get(), SIGNAL(saving()), this, SLOT(maybe_reopen_camera()), Qt::DirectConnection);
+    connect(s.b.get(), SIGNAL(saving()), this, SLOT(schedule_reopen_camera()), Qt::DirectConnection);
     connect(&s.fov, SIGNAL(valueChanged(int)), this, SLOT(set_fov(int)), Qt::DirectConnection);
     set_fov(s.fov);
 }
@@ -59,20 +62,31 @@ void Tracker_PT::run()
     QTextStream log_stream(&log_file);
 #endif
 
+#ifdef PT_DEBUG_ALLOCATIONS
+    // frames at the same size so far. the first ones set up the buffers.
+    unsigned steady_frames = 0;
+    cv::Size last_size;
+#endif
+
+    // reading a frame blocks until the camera has one. with that on
+    // a thread of its own, the next frame comes in while this one's
+    // being processed.
+    std::thread capture_thread([this] { capture(); });
+
     while((commands & ABORT) == 0)
     {
-        CamInfo cam_info;
-        bool new_frame = false;
-
+        // with a timeout, so that ABORT is seen without a camera too
+        if (frames.take(100))
         {
-            QMutexLocker l(&camera_mtx);
+            const captured_frame& cur = frames.read_slot();
+            const cv::Mat& frame = cur.frame;
+            const CamInfo& cam_info = cur.info;
+            const long long frame_time = cur.time;
 
-            if (camera)
-                std::tie(new_frame, cam_info) = camera.get_frame(frame);
-        }
+#ifdef PT_DEBUG_ALLOCATIONS
+            alloc_counter allocs;
+#endif
 
-        if (new_frame)
-        {
             cv::resize(frame, preview_frame,
                        cv::Size(preview_size.width(), preview_size.height()),
                        0, 0, cv::INTER_NEAREST);
@@ -86,12 +100,21 @@ void Tracker_PT::run()
 
             if (success)
             {
+                const PointModel model(s);
+
                 point_tracker.track(points,
-                                    PointModel(s),
+                                    model,
                                     cam_info,
                                     s.dynamic_pose ? s.init_phase_timeout : 0);
                 ever_success = true;
+                notify_new_sample(frame_time);
+
+                // the next frame only gets searched around these, if they're all there
+                const auto predicted = point_tracker.project_model(model, fx);
+                point_extractor.set_prediction(predicted.data(), unsigned(predicted.size()));
             }
+            else
+                point_extractor.set_prediction(nullptr, 0);
 
             {
                 Affine X_CM;
@@ -123,12 +146,56 @@ void Tracker_PT::run()
                          1);
             }
 
+#ifdef PT_DEBUG_ALLOCATIONS
+            if (frame.size() != last_size)
+            {
+                last_size = frame.size();
+                steady_frames = 0;
+            }
+            else if (++steady_frames > 2)
+                assert(allocs.count() == 0 && "frame allocated image buffers");
+#endif
+
             video_widget->update_image(preview_frame);
         }
     }
+
+    capture_thread.join();
+
     qDebug() << "pt: thread stopped";
 }
 
+void Tracker_PT::capture()
+{
+    while ((commands & ABORT) == 0)
+    {
+        if (commands & REOPEN_CAMERA)
+        {
+            reset_command(REOPEN_CAMERA);
+            maybe_reopen_camera();
+        }
+
+        captured_frame& f = frames.write_slot();
+        bool open = false, new_frame = false;
+
+        {
+            QMutexLocker l(&camera_mtx);
+
+            if (camera)
+            {
+                open = true;
+                std::tie(new_frame, f.info) = camera.get_frame(f.frame);
+                f.time = camera.get_frame_time();
+            }
+        }
+
+        if (new_frame)
+            frames.publish();
+        else if (!open)
+            portable::sleep(10);
+    }
+}
+
 void Tracker_PT::maybe_reopen_camera()
 {
     QMutexLocker l(&camera_mtx);
@@ -140,13 +207,17 @@ void Tracker_PT::maybe_reopen_camera()
     case Camera::open_error:
         break;
     case Camera::open_ok_change:
-        frame = cv::Mat();
-        break;
     case Camera::open_ok_no_change:
         break;
     }
 }
 
+// don't make whoever saved the settings wait for the camera
+void Tracker_PT::schedule_reopen_camera()
+{
+    set_command(REOPEN_CAMERA);
+}
+
 void Tracker_PT::set_fov(int value)
 {
     QMutexLocker l(&camera_mtx);
@@ -235,6 +306,16 @@ int Tracker_PT::get_n_points()
     return int(point_count);
 }
 
+unsigned long long Tracker_PT::get_dropped_frames()
+{
+    return frames.dropped();
+}
+
+PointExtractor::search_stats Tracker_PT::get_search_stats()
+{
+    return point_extractor.get_search_stats();
+}
+
 bool Tracker_PT::get_cam_info(CamInfo* info)
 {
     QMutexLocker lock(&camera_mtx);
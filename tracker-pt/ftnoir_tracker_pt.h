@@ -16,6 +16,7 @@
 #include "camera.h"
 #include "point_extractor.h"
 #include "point_tracker.h"
+#include "triple_buffer.h"
 #include "cv/video-widget.hpp"
 #include "compat/util.hpp"
 
@@ -51,9 +52,12 @@ public:
 
     Affine pose();
     int  get_n_points();
+    unsigned long long get_dropped_frames();
+    PointExtractor::search_stats get_search_stats();
     bool get_cam_info(CamInfo* info);
 public slots:
     void maybe_reopen_camera();
+    void schedule_reopen_camera();
     void set_fov(int value);
 protected:
     void run() override;
@@ -61,22 +65,34 @@ private:
     // thread commands
     enum Command : unsigned char
     {
-        ABORT = 1<<0
+        ABORT = 1<<0,
+        REOPEN_CAMERA = 1<<1,
     };
     void set_command(Command command);
     void reset_command(Command command);
 
+    // runs on a thread of its own, started and joined by run()
+    void capture();
+
+    struct captured_frame
+    {
+        cv::Mat frame;
+        CamInfo info;
+        long long time = 0;
+    };
+
     QMutex camera_mtx;
     QMutex data_mtx;
     Camera       camera;
     PointExtractor point_extractor;
     PointTracker   point_tracker;
+    pt_impl::triple_buffer<captured_frame> frames;
 
     std::unique_ptr<cv_video_widget> video_widget;
     std::unique_ptr<QLayout> layout;
 
     settings_pt s;
-    cv::Mat frame, preview_frame;
+    cv::Mat preview_frame;
     std::vector<vec2> points;
 
     QSize preview_size;
@@ -191,11 +191,32 @@ void TrackerDialog_PT::poll_tracker_info_impl()
     CamInfo info;
     if (tracker && tracker->get_cam_info(&info))
     {
-        ui.caminfo_label->setText(tr("%1x%2 @ %3 FPS").arg(info.res_x).arg(info.res_y).arg(iround(info.fps)));
+        QString cam_text = tr("%1x%2 @ %3 FPS").arg(info.res_x).arg(info.res_y).arg(iround(info.fps));
+
+        // frames that came in while the last one was still being processed
+        const unsigned long long dropped = tracker->get_dropped_frames();
+        if (dropped > 0)
+            cam_text += QStringLiteral(" ") + tr("(%1 dropped)").arg(dropped);
+
+        ui.caminfo_label->setText(cam_text);
 
         // display point info
         const int n_points = tracker->get_n_points();
-        ui.pointinfo_label->setText((n_points == 3 ? tr("%1 OK!") : tr("%1 BAD!")).arg(n_points));
+        QString text = (n_points == 3 ? tr("%1 OK!") : tr("%1 BAD!")).arg(n_points);
+
+        // how often the points were found around where they were expected
+        const PointExtractor::search_stats stats = tracker->get_search_stats();
+        const unsigned long long hits = stats.roi_hits - last_search_stats.roi_hits,
+                                 frames = hits + stats.full_frames - last_search_stats.full_frames,
+                                 pixels = stats.pixels - last_search_stats.pixels;
+        last_search_stats = stats;
+
+        if (frames > 0)
+            text += QStringLiteral(" ") + tr("(ROI %1%, %2 px/frame)")
+                                          .arg(iround(hits * 100. / frames))
+                                          .arg(pixels / frames);
+
+        ui.pointinfo_label->setText(text);
     }
     else
     {
@@ -263,6 +284,7 @@ void TrackerDialog_PT::doCancel()
 void TrackerDialog_PT::register_tracker(ITracker *t)
 {
     tracker = static_cast<Tracker_PT*>(t);
+    last_search_stats = PointExtractor::search_stats();
     ui.tcalib_button->setEnabled(true);
     poll_tracker_info();
     timer.start();
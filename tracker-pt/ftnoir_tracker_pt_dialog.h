@@ -45,6 +45,8 @@ private:
     QTimer timer, calib_timer;
     TranslationCalibrator trans_calib;
     QMutex calibrator_mutex;
+    // as of the last poll, to show what changed since
+    PointExtractor::search_stats last_search_stats;
 
     Ui::UICPTClientControls ui;
 };
@@ -0,0 +1,212 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+// checks tracker-pt's mean_shift against the plain double loop it
+// replaced, on synthetic blobs, then times both.
+//
+// opentrack-tracker-pt-mean-shift-bench [repeat]
+
+#include "../mean_shift.h"
+#include "compat/macros.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+using namespace types;
+using namespace pt_impl;
+
+namespace {
+
+// same as in PointExtractor::extract_points()
+constexpr f radius_c = f(1.75);
+constexpr int max_iterations = 10;
+
+constexpr unsigned blob_count = 16;
+constexpr f max_distance = f(.01);
+
+struct blob
+{
+    cv::Mat1b roi;
+    f radius;
+};
+
+// the old MeanShiftIteration() from point_extractor.cpp
+vec2 reference_iterate(const cv::Mat& frame_gray, const vec2& current_center, f filter_width)
+{
+    const f s = 1.0 / filter_width;
+
+    f m = 0;
+    vec2 com { 0, 0 };
+    for (int i = 0; i < frame_gray.rows; i++)
+    {
+        auto frame_ptr = (const unsigned char* restrict_ptr)frame_gray.ptr(i);
+        for (int j = 0; j < frame_gray.cols; j++)
+        {
+            f val = frame_ptr[j];
+            val = val * val;
+            {
+                f dx = (j - current_center[0])*s;
+                f dy = (i - current_center[1])*s;
+                f f = std::fmax(0, 1 - dx*dx - dy*dy);
+                val *= f;
+            }
+            m += val;
+            com[0] += j * val;
+            com[1] += i * val;
+        }
+    }
+    if (m > f(.1))
+    {
+        com *= f(1) / m;
+        return com;
+    }
+    else
+        return current_center;
+}
+
+// the convergence loop from PointExtractor::extract_points()
+template<typename F>
+vec2 converge(const blob& b, F&& iterate, int& iterations)
+{
+    const f kernel_radius = b.radius * radius_c;
+    vec2 pos(b.roi.cols/2., b.roi.rows/2.);
+
+    iterations = 0;
+
+    for (int iter = 0; iter < max_iterations; ++iter)
+    {
+        vec2 com_new = iterate(pos, kernel_radius);
+        vec2 delta = com_new - pos;
+        pos = com_new;
+        iterations++;
+        if (delta.dot(delta) < 1e-2)
+            break;
+    }
+
+    return pos;
+}
+
+// a soft spot off the roi's center over some sensor noise, sized the
+// way the labeler would crop it
+std::vector<blob> make_blobs()
+{
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<f> offset(-1.5, 1.5);
+    std::uniform_int_distribution<int> noise(0, 12);
+
+    std::vector<blob> ret;
+    ret.reserve(blob_count);
+
+    for (unsigned k = 0; k < blob_count; k++)
+    {
+        const f radius = 1.5 + k;
+        const int size = int(std::ceil(radius * 2 * radius_c)) + 3;
+        const f cx = size/2. + offset(rng), cy = size/2. + offset(rng);
+        const f sigma = radius * .6;
+
+        blob b { cv::Mat1b(size, size), radius };
+
+        for (int i = 0; i < size; i++)
+            for (int j = 0; j < size; j++)
+            {
+                const f d2 = (j - cx)*(j - cx) + (i - cy)*(i - cy);
+                const f val = 255 * std::exp(-d2 / (2 * sigma * sigma)) + noise(rng);
+                b.roi(i, j) = (unsigned char) std::min(f(255), val);
+            }
+
+        ret.push_back(std::move(b));
+    }
+
+    return ret;
+}
+
+template<typename F>
+double time_ns_per_blob(const std::vector<blob>& blobs, unsigned repeat, F&& run)
+{
+    using clock = std::chrono::steady_clock;
+
+    const clock::time_point start = clock::now();
+
+    for (unsigned r = 0; r < repeat; r++)
+        for (const blob& b : blobs)
+            run(b);
+
+    const clock::duration elapsed = clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(repeat) * blobs.size());
+}
+
+} // ns
+
+int main(int argc, char** argv)
+{
+    const unsigned repeat = argc > 1 ? std::max(1u, unsigned(std::strtoul(argv[1], nullptr, 10))) : 2000u;
+
+    const std::vector<blob> blobs = make_blobs();
+    mean_shift ms;
+    bool ok = true;
+
+    for (const blob& b : blobs)
+    {
+        int ref_iters = 0, iters = 0;
+
+        const vec2 ref_pos = converge(b, [&](const vec2& pos, f width) {
+            return reference_iterate(b.roi, pos, width);
+        }, ref_iters);
+
+        ms.set_image(b.roi);
+        const vec2 pos = converge(b, [&](const vec2& pos, f width) {
+            return ms.iterate(pos, width);
+        }, iters);
+
+        const vec2 delta = pos - ref_pos;
+        const f distance = std::sqrt(delta.dot(delta));
+        const bool same = iters == ref_iters && distance < max_distance;
+
+        std::printf("radius %4.1f px, %2dx%-2d roi: %2d iterations (reference %2d), %.2e px apart%s\n",
+                    b.radius, b.roi.cols, b.roi.rows, iters, ref_iters, distance,
+                    same ? "" : "  MISMATCH");
+
+        ok &= same;
+    }
+
+    // keeps the optimizer from dropping the loops
+    volatile f sink = 0;
+
+    const double ref_ns = time_ns_per_blob(blobs, repeat, [&](const blob& b) {
+        int iters;
+        sink = sink + converge(b, [&](const vec2& pos, f width) {
+            return reference_iterate(b.roi, pos, width);
+        }, iters)[0];
+    });
+
+    const double ns = time_ns_per_blob(blobs, repeat, [&](const blob& b) {
+        int iters;
+        ms.set_image(b.roi);
+        sink = sink + converge(b, [&](const vec2& pos, f width) {
+            return ms.iterate(pos, width);
+        }, iters)[0];
+    });
+
+    std::printf("%u blobs x %u: reference %.0f ns/blob, mean_shift %.0f ns/blob, %.2fx\n",
+                blob_count, repeat, ref_ns, ns, ns > 0 ? ref_ns / ns : 0.);
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "mean_shift disagrees with the reference\n");
+        return 1;
+    }
+
+    return 0;
+}
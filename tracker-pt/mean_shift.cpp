@@ -0,0 +1,137 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#include "mean_shift.h"
+#include "compat/macros.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined __SSE2__ || defined _M_X64 || defined _M_AMD64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define PT_MEAN_SHIFT_SSE2
+#endif
+
+using namespace pt_impl;
+
+/*
+http://en.wikipedia.org/wiki/Mean-shift
+In this application the idea, is to eliminate any bias of the point estimate 
+which is introduced by the rather arbitrary thresholded area. One must recognize
+that the thresholded area can only move in one pixel increments since it is
+binary. Thus, its center of mass might make "jumps" as pixels are added/removed
+from the thresholded area.
+With mean-shift, a moving "window" or kernel is multiplied with the gray-scale
+image, and the COM is calculated of the result. This is iterated where the
+kernel center is set the previously computed COM. Thus, peaks in the image intensity
+distribution "pull" the kernel towards themselves. Eventually it stops moving, i.e.
+then the computed COM coincides with the kernel center. We hope that the 
+corresponding location is a good candidate for the extracted point.
+The idea similar to the window scaling suggested in  Berglund et al. "Fast, bias-free 
+algorithm for tracking single particles with variable size and shape." (2008).
+*/
+
+#if defined PT_MEAN_SHIFT_SSE2
+static inline float horizontal_sum(__m128 x)
+{
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+    return _mm_cvtss_f32(x);
+}
+#endif
+
+void mean_shift::set_image(const cv::Mat& frame_gray)
+{
+    rows = frame_gray.rows;
+    cols = frame_gray.cols;
+
+    // grows to the largest blob seen, then stays
+    tile.resize(unsigned(rows * cols));
+    column_term.resize(unsigned(cols));
+
+    for (int i = 0; i < rows; i++)
+    {
+        const unsigned char* restrict_ptr src = frame_gray.ptr(i);
+        float* restrict_ptr dest = tile.data() + i * cols;
+
+        // taking the square weighs brighter parts of the image stronger
+        for (int j = 0; j < cols; j++)
+            dest[j] = float(src[j]) * float(src[j]);
+    }
+}
+
+vec2 mean_shift::iterate(const vec2& center, f filter_width)
+{
+    const float s2 = float(1 / (filter_width * filter_width));
+    const float cx = float(center[0]), cy = float(center[1]);
+
+    // 1 - dx^2 - dy^2, with the dx part the same for every row
+    for (int j = 0; j < cols; j++)
+    {
+        const float dx = j - cx;
+        column_term[unsigned(j)] = dx * dx * s2;
+    }
+
+    double m = 0, mx = 0, my = 0;
+
+    for (int i = 0; i < rows; i++)
+    {
+        const float dy = i - cy;
+        const float row_term = 1 - dy * dy * s2;
+
+        // outside the kernel
+        if (row_term <= 0)
+            continue;
+
+        // the columns where the kernel isn't zero, give or take one
+        const float half = std::sqrt(row_term / s2);
+        const int j0 = std::max(0, int(std::floor(cx - half))),
+                  j1 = std::min(cols, int(std::ceil(cx + half)) + 1);
+
+        const float* restrict_ptr row = tile.data() + i * cols;
+        const float* restrict_ptr ax = column_term.data();
+
+        float row_m = 0, row_mx = 0;
+        int j = j0;
+
+#if defined PT_MEAN_SHIFT_SSE2
+        {
+            const __m128 zero = _mm_setzero_ps(), four = _mm_set1_ps(4), by = _mm_set1_ps(row_term);
+            __m128 jv = _mm_setr_ps(float(j), float(j + 1), float(j + 2), float(j + 3));
+            __m128 acc_m = zero, acc_mx = zero;
+
+            for (; j + 4 <= j1; j += 4)
+            {
+                const __m128 w = _mm_max_ps(zero, _mm_sub_ps(by, _mm_loadu_ps(ax + j)));
+                const __m128 val = _mm_mul_ps(_mm_loadu_ps(row + j), w);
+                acc_m = _mm_add_ps(acc_m, val);
+                acc_mx = _mm_add_ps(acc_mx, _mm_mul_ps(jv, val));
+                jv = _mm_add_ps(jv, four);
+            }
+
+            row_m = horizontal_sum(acc_m);
+            row_mx = horizontal_sum(acc_mx);
+        }
+#endif
+
+        for (; j < j1; j++)
+        {
+            const float val = row[j] * std::max(0.f, row_term - ax[j]);
+            row_m += val;
+            row_mx += j * val;
+        }
+
+        m += row_m;
+        mx += row_mx;
+        my += i * double(row_m);
+    }
+
+    if (m > f(.1))
+        return vec2(mx / m, my / m);
+    else
+        return center;
+}
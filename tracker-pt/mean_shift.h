@@ -0,0 +1,36 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include "cv/numeric.hpp"
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace pt_impl {
+
+using namespace types;
+
+// mean-shift over a window of the grayscale frame. the squared
+// intensities are kept between iterations, as floats, and the kernel
+// is split into a row and a column term so that each pixel is only a
+// subtract, a max and a few multiply-adds.
+class mean_shift final
+{
+    std::vector<float> tile, column_term;
+    int rows = 0, cols = 0;
+
+public:
+    void set_image(const cv::Mat& frame_gray);
+    // the kernel-weighted center of mass around `center', or `center'
+    // itself if there's nothing there
+    vec2 iterate(const vec2& center, f filter_width);
+};
+
+} // ns pt_impl
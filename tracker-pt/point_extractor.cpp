@@ -30,59 +30,13 @@
 using namespace types;
 using namespace pt_impl;
 
-/*
-http://en.wikipedia.org/wiki/Mean-shift
-In this application the idea, is to eliminate any bias of the point estimate 
-which is introduced by the rather arbitrary thresholded area. One must recognize
-that the thresholded area can only move in one pixel increments since it is
-binary. Thus, its center of mass might make "jumps" as pixels are added/removed
-from the thresholded area.
-With mean-shift, a moving "window" or kernel is multiplied with the gray-scale
-image, and the COM is calculated of the result. This is iterated where the
-kernel center is set the previously computed COM. Thus, peaks in the image intensity
-distribution "pull" the kernel towards themselves. Eventually it stops moving, i.e.
-then the computed COM coincides with the kernel center. We hope that the 
-corresponding location is a good candidate for the extracted point.
-The idea similar to the window scaling suggested in  Berglund et al. "Fast, bias-free 
-algorithm for tracking single particles with variable size and shape." (2008).
-*/
-static cv::Vec2d MeanShiftIteration(const cv::Mat &frame_gray, const vec2 &current_center, f filter_width)
-{
-    // Most amazingly this function runs faster with doubles than with floats.
-    const f s = 1.0 / filter_width;
-
-    f m = 0;
-    vec2 com { 0, 0  };
-    for (int i = 0; i < frame_gray.rows; i++)
-    {
-        auto frame_ptr = (uint8_t const* restrict_ptr)frame_gray.ptr(i);
-        for (int j = 0; j < frame_gray.cols; j++)
-        {
-            f val = frame_ptr[j];
-            val = val * val; // taking the square wights brighter parts of the image stronger.
-            {
-                f dx = (j - current_center[0])*s;
-                f dy = (i - current_center[1])*s;
-                f f = std::fmax(0, 1 - dx*dx - dy*dy);
-                val *= f;
-            }
-            m += val;
-            com[0] += j * val;
-            com[1] += i * val;
-        }
-    }
-    if (m > f(.1))
-    {
-        com *= f(1) / m;
-        return com;
-    }
-    else
-        return current_center;
-}
-
 PointExtractor::PointExtractor()
 {
     blobs.reserve(max_blobs);
+    // what calcHist() makes for 256 bins, so that it doesn't make another
+    hist = cv::Mat1f(256, 1);
+    predicted.reserve(PointModel::N_POINTS);
+    windows.reserve(PointModel::N_POINTS);
 }
 
 void PointExtractor::ensure_channel_buffers(const cv::Mat& orig_frame)
@@ -96,18 +50,17 @@ void PointExtractor::ensure_buffers(const cv::Mat& frame)
 {
     const int W = frame.cols, H = frame.rows;
 
-    if (frame_gray.rows != W || frame_gray.cols != H)
+    // everything else gets sized here too, so that frames
+    // of the same size don't allocate anything
+    if (frame_gray.rows != H || frame_gray.cols != W)
     {
         frame_gray = cv::Mat1b(H, W);
-        frame_bin = cv::Mat1b(H, W);
-        frame_blobs = cv::Mat1b(H, W);
+        labeler.reserve(W);
     }
 }
 
 void PointExtractor::extract_single_channel(const cv::Mat& orig_frame, int idx, cv::Mat& dest)
 {
-    ensure_channel_buffers(orig_frame);
-
     const int from_to[] = {
         idx, 0,
     };
@@ -138,10 +91,9 @@ void PointExtractor::color_to_grayscale(const cv::Mat& frame, cv::Mat1b& output)
     }
     case pt_color_average:
     {
-        const int W = frame.cols, H = frame.rows;
-        const cv::Mat tmp = frame.reshape(1, W * H);
-        cv::Mat output_ = output.reshape(1, W * H);
-        cv::reduce(tmp, output_, 1, cv::REDUCE_AVG);
+        // unlike reshape and reduce, works on a window of the frame
+        static const cv::Matx13f avg(1.f/3, 1.f/3, 1.f/3);
+        cv::transform(frame, output, avg);
         break;
     }
     default:
@@ -153,14 +105,12 @@ void PointExtractor::color_to_grayscale(const cv::Mat& frame, cv::Mat1b& output)
     }
 }
 
-void PointExtractor::threshold_image(const cv::Mat& frame_gray, cv::Mat1b& output)
+int PointExtractor::threshold_value(const cv::Mat& frame_gray)
 {
     const int threshold_slider_value = s.threshold_slider.to<int>();
 
     if (!s.auto_threshold)
-    {
-        cv::threshold(frame_gray, output, threshold_slider_value, 255, cv::THRESH_BINARY);
-    }
+        return threshold_slider_value;
     else
     {
         const int hist_size = 256;
@@ -192,7 +142,7 @@ void PointExtractor::threshold_image(const cv::Mat& frame_gray, cv::Mat1b& outpu
             }
         }
 
-        cv::threshold(frame_gray, output, thres, 255, CV_THRESH_BINARY);
+        return int(thres);
     }
 }
 
@@ -208,76 +158,145 @@ double PointExtractor::threshold_radius_value(int w, int h, int threshold)
     return radius;
 }
 
-void PointExtractor::extract_points(const cv::Mat& frame, cv::Mat& preview_frame, std::vector<vec2>& points)
+void PointExtractor::set_prediction(const vec2* points, unsigned n)
 {
-    ensure_buffers(frame);
-    color_to_grayscale(frame, frame_gray);
-
-#if defined PREVIEW
-    cv::imshow("capture", frame_gray);
-    cv::waitKey(1);
-#endif
+    predicted.assign(points, points + n);
+}
 
-    threshold_image(frame_gray, frame_bin);
+PointExtractor::search_stats PointExtractor::get_search_stats() const
+{
+    search_stats ret;
+    ret.roi_hits = roi_hits;
+    ret.full_frames = full_frames;
+    ret.pixels = pixels;
+    return ret;
+}
 
+void PointExtractor::collect_blobs()
+{
     blobs.clear();
-    frame_bin.copyTo(frame_blobs);
 
     const f region_size_min = s.min_point_size;
     const f region_size_max = s.max_point_size;
 
-    unsigned idx = 0;
-    for (int y=0; y < frame_blobs.rows; y++)
+    for (const blob_labeler::component& c : labeler.components())
     {
-        const unsigned char* ptr_bin = frame_blobs.ptr(y);
-        for (int x=0; x < frame_blobs.cols; x++)
-        {
-            if (ptr_bin[x] != 255)
-                continue;
-            idx = blobs.size() + 1;
-
-            cv::Rect rect;
-            cv::floodFill(frame_blobs,
-                          cv::Point(x,y),
-                          cv::Scalar(idx),
-                          &rect,
-                          cv::Scalar(0),
-                          cv::Scalar(0),
-                          4 | cv::FLOODFILL_FIXED_RANGE);
-
-            unsigned cnt = 0;
-            unsigned norm = 0;
-
-            const int ymax = rect.y+rect.height,
-                      xmax = rect.x+rect.width;
-
-            for (int i=rect.y; i < ymax; i++)
-            {
-                unsigned char* restrict_ptr ptr_blobs = frame_blobs.ptr(i);
-                unsigned char const* restrict_ptr ptr_gray = frame_gray.ptr(i);
-                for (int j=rect.x; j < xmax; j++)
-                {
-                    if (ptr_blobs[j] != idx)
-                        continue;
+        const double radius = std::sqrt(c.area / M_PI);
+        if (radius > region_size_max || radius < region_size_min)
+            continue;
+
+        cv::Rect rect = c.rect();
+
+        blob b(radius, vec2(rect.width/2., rect.height/2.), std::pow(f(c.sum), f(1.1))/c.area, rect);
+        blobs.push_back(b);
+
+        if (blobs.size() >= unsigned(max_blobs))
+            break;
+    }
+}
+
+bool PointExtractor::search_windows(const cv::Mat& frame)
+{
+    if (predicted.empty() || full_scan_timer.elapsed_ms() >= full_scan_interval_ms)
+        return false;
+
+    const int W = frame.cols, H = frame.rows;
+    const cv::Rect bounds(0, 0, W, H);
+    // how far a point can move between frames, plus its own size
+    const int r = W / 16 + iround(2 * s.max_point_size);
+
+    windows.clear();
+
+    for (const vec2& p : predicted)
+    {
+        const int x = iround(p[0] * W + W/2.), y = iround(-p[1] * W + H/2.);
+        const cv::Rect rect = cv::Rect(x - r, y - r, 2*r + 1, 2*r + 1) & bounds;
+
+        if (rect.area() == 0)
+            return false;
+
+        windows.push_back(rect);
+    }
+
+    // otherwise the same blob would be found twice
+    for (bool merged = true; merged; )
+    {
+        merged = false;
 
-                    //ptr_blobs[j] = 0;
-                    norm += ptr_gray[j];
-                    cnt++;
+        for (unsigned i = 0; i < windows.size() && !merged; i++)
+            for (unsigned j = i + 1; j < windows.size(); j++)
+                if ((windows[i] & windows[j]).area() > 0)
+                {
+                    windows[i] |= windows[j];
+                    windows.erase(windows.begin() + j);
+                    merged = true;
+                    break;
                 }
-            }
+    }
+
+    // the histogram would need the whole frame
+    const int thres = s.auto_threshold ? last_threshold : s.threshold_slider.to<int>();
+
+    labeler.clear();
 
-            const double radius = std::sqrt(cnt / M_PI);
-            if (radius > region_size_max || radius < region_size_min)
-                continue;
+    bool ok = true;
 
-            blob b(radius, vec2(rect.width/2., rect.height/2.), std::pow(f(norm), f(1.1))/cnt, rect);
-            blobs.push_back(b);
+    for (const cv::Rect& rect : windows)
+    {
+        cv::Mat1b gray = frame_gray(rect);
+        color_to_grayscale(frame(rect), gray);
+
+        pixels += unsigned(rect.area());
 
-            if (idx >= max_blobs)
-                goto end;
+        // a blob that's cut off would have the wrong size and center
+        if (!labeler.add(frame_gray, thres, rect))
+        {
+            ok = false;
+            break;
         }
     }
-end:
+
+    if (ok)
+    {
+        collect_blobs();
+        ok = blobs.size() >= PointModel::N_POINTS;
+    }
+
+    if (ok)
+        roi_hits++;
+
+    return ok;
+}
+
+void PointExtractor::search_frame(const cv::Mat& frame)
+{
+    color_to_grayscale(frame, frame_gray);
+
+#if defined PREVIEW
+    cv::imshow("capture", frame_gray);
+    cv::waitKey(1);
+#endif
+
+    last_threshold = threshold_value(frame_gray);
+
+    // thresholds, labels and sums up brightness in one go
+    labeler.label(frame_gray, last_threshold);
+
+    pixels += unsigned(frame.cols * frame.rows);
+    full_frames++;
+    full_scan_timer.start();
+
+    collect_blobs();
+}
+
+void PointExtractor::extract_points(const cv::Mat& frame, cv::Mat& preview_frame, std::vector<vec2>& points)
+{
+    ensure_buffers(frame);
+
+    const bool windowed = search_windows(frame);
+
+    if (!windowed)
+        search_frame(frame);
 
     const int W = frame_gray.cols;
     const int H = frame_gray.rows;
@@ -286,7 +305,7 @@ end:
 
     std::sort(blobs.begin(), blobs.end(), [](const blob& b1, const blob& b2) { return b2.brightness < b1.brightness; });
 
-    for (idx = 0; idx < sz; ++idx)
+    for (unsigned idx = 0; idx < sz; ++idx)
     {
         blob &b = blobs[idx];
         cv::Rect rect = b.rect;
@@ -297,6 +316,13 @@ end:
         rect.height *= 2;
         rect &= cv::Rect(0, 0, W, H);  // crop at frame boundaries
 
+        // can reach out of the windows, only those are in grayscale
+        if (windowed)
+        {
+            cv::Mat1b gray = frame_gray(rect);
+            color_to_grayscale(frame(rect), gray);
+        }
+
         cv::Mat frame_roi = frame_gray(rect);
 
         // smaller values mean more changes. 1 makes too many changes while 1.5 makes about .1
@@ -305,9 +331,11 @@ end:
         const f kernel_radius = b.radius * radius_c;
         vec2 pos(rect.width/2., rect.height/2.); // position relative to ROI.
 
+        meanshift.set_image(frame_roi);
+
         for (int iter = 0; iter < 10; ++iter)
         {
-            vec2 com_new = MeanShiftIteration(frame_roi, pos, kernel_radius);
+            vec2 com_new = meanshift.iterate(pos, kernel_radius);
             vec2 delta = com_new - pos;
             pos = com_new;
             if (delta.dot(delta) < 1e-2)
@@ -10,9 +10,13 @@
 
 #include "ftnoir_tracker_pt_settings.h"
 #include "camera.h"
+#include "blob_labeler.h"
+#include "mean_shift.h"
 #include "cv/numeric.hpp"
+#include "compat/timer.hpp"
 
 #include <vector>
+#include <atomic>
 
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
@@ -33,20 +37,45 @@ struct blob
 class PointExtractor final
 {
 public:
+    struct search_stats
+    {
+        // frames where the points were all found around where they were
+        // expected, and ones that had the whole frame scanned
+        unsigned long long roi_hits = 0, full_frames = 0;
+        // thresholded and labeled, including failed window searches
+        unsigned long long pixels = 0;
+    };
+
     // extracts points from frame and draws some processing info into frame, if draw_output is set
     // dt: time since last call in seconds
     void extract_points(const cv::Mat& frame, cv::Mat& preview_frame, std::vector<vec2>& points);
     PointExtractor();
 
+    // where the points are expected in the next frame, in the same
+    // coordinates as extract_points() returns. none means scan everything.
+    void set_prediction(const vec2* points, unsigned n);
+    search_stats get_search_stats() const;
+
     settings_pt s;
 
     static double threshold_radius_value(int w, int h, int threshold);
 private:
     static constexpr int max_blobs = 16;
+    // so that new points and threshold changes get noticed
+    static constexpr int full_scan_interval_ms = 250;
 
-    cv::Mat1b frame_gray, frame_bin, frame_blobs;
+    cv::Mat1b frame_gray;
     cv::Mat1f hist;
     std::vector<blob> blobs;
+    blob_labeler labeler;
+    mean_shift meanshift;
+
+    std::vector<vec2> predicted;
+    std::vector<cv::Rect> windows;
+    Timer full_scan_timer;
+    int last_threshold = 0;
+
+    std::atomic<unsigned long long> roi_hits { 0 }, full_frames { 0 }, pixels { 0 };
     cv::Mat1b ch[3];
 
     void ensure_channel_buffers(const cv::Mat& orig_frame);
@@ -56,7 +85,12 @@ private:
     void extract_channels(const cv::Mat& orig_frame, const int* order, int order_npairs);
 
     void color_to_grayscale(const cv::Mat& frame, cv::Mat1b& output);
-    void threshold_image(const cv::Mat& frame_gray, cv::Mat1b& output);
+    // only around the predicted points, false if some weren't found
+    bool search_windows(const cv::Mat& frame);
+    void search_frame(const cv::Mat& frame);
+    void collect_blobs();
+    // pixels brighter than this are part of a blob
+    int threshold_value(const cv::Mat& frame_gray);
 };
 
 } // ns impl
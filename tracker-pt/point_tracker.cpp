@@ -407,3 +407,11 @@ vec2 PointTracker::project(const vec3& v_M, f focal_length, const Affine& X_CM)
     return vec2(focal_length*v_C[0]/v_C[2], focal_length*v_C[1]/v_C[2]);
 }
 
+std::array<vec2, PointModel::N_POINTS> PointTracker::project_model(const PointModel& model, f focal_length)
+{
+    return {
+        project(vec3(0, 0, 0), focal_length),
+        project(model.M01, focal_length),
+        project(model.M02, focal_length),
+    };
+}
@@ -62,6 +62,8 @@ public:
     Affine pose() { return X_CM; }
     vec2 project(const vec3& v_M, f focal_length);
     vec2 project(const vec3& v_M, f focal_length, const Affine& X_CM);
+    // where the model's points end up with the current pose
+    std::array<vec2, PointModel::N_POINTS> project_model(const PointModel& model, f focal_length);
 
 private:
     // the points in model order
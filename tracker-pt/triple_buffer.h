@@ -0,0 +1,81 @@
+/* Copyright (c) 2017 Stanislaw Halik <sthalik@misaki.pl>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace pt_impl {
+
+// one writer, one reader. the writer never waits and the reader always
+// gets the newest item. an item the reader didn't take before the next
+// one came is dropped, not queued.
+template<typename t>
+class triple_buffer final
+{
+    // set in `middle' when the writer put something there
+    static constexpr unsigned fresh = 4;
+
+    t items[3];
+
+    // the writer's and the reader's own, not shared
+    unsigned write_idx = 0, read_idx = 1;
+    // the one in between, swapped with either side
+    std::atomic<unsigned> middle { 2 };
+
+    std::atomic<unsigned long long> drops { 0 };
+
+    // only for waiting, the items don't need it
+    std::mutex mtx;
+    std::condition_variable cvar;
+
+public:
+    // the writer fills this in, then calls publish()
+    t& write_slot() { return items[write_idx]; }
+
+    void publish()
+    {
+        const unsigned prev = middle.exchange(write_idx | fresh, std::memory_order_acq_rel);
+        write_idx = prev & ~fresh;
+
+        if (prev & fresh)
+            drops++;
+
+        {
+            std::lock_guard<std::mutex> l(mtx);
+        }
+        cvar.notify_one();
+    }
+
+    // false if nothing new came before the timeout
+    bool take(int timeout_ms)
+    {
+        if (!(middle.load(std::memory_order_acquire) & fresh))
+        {
+            std::unique_lock<std::mutex> l(mtx);
+
+            if (!cvar.wait_for(l, std::chrono::milliseconds(timeout_ms),
+                               [this] { return (middle.load(std::memory_order_acquire) & fresh) != 0; }))
+                return false;
+        }
+
+        read_idx = middle.exchange(read_idx, std::memory_order_acq_rel) & ~fresh;
+        return true;
+    }
+
+    // what take() got last
+    const t& read_slot() const { return items[read_idx]; }
+
+    unsigned long long dropped() const { return drops; }
+};
+
+template<typename t> constexpr unsigned triple_buffer<t>::fresh;
+
+} // ns pt_impl
@@ -10,6 +10,7 @@
 #include "api/plugin-api.hpp"
 #include "compat/nan.hpp"
 #include "compat/util.hpp"
+#include "compat/timer.hpp"
 
 #include <iterator>
 
@@ -36,12 +37,16 @@ void udp::run()
             QMutexLocker foo(&mutex);
 
             bool ok = false;
+            long long recv_time = 0;
 
             do
             {
                 const qint64 sz = sock.readDatagram(reinterpret_cast<char*>(last_recv_pose2), sizeof(double[6]));
                 if (sz > 0)
+                {
                     ok = true;
+                    recv_time = Timer::now_nsecs();
+                }
             }
             while (sock.hasPendingDatagrams());
 
@@ -59,6 +64,8 @@ void udp::run()
             {
                 for (unsigned i = 0; i < 6; i++)
                     last_recv_pose[i] = last_recv_pose2[i];
+
+                notify_new_sample(recv_time);
             }
         }
 